@@ -0,0 +1,170 @@
+#include "IoUring.h"
+
+#ifdef QGC_IO_URING_AVAILABLE
+
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+IoUring::IoUring()
+{
+}
+
+IoUring::~IoUring()
+{
+    close();
+}
+
+bool IoUring::open(unsigned entries, unsigned completionEntries)
+{
+    close();
+
+    io_uring_params params{};
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = completionEntries;
+    _fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (_fd < 0) {
+        return false;
+    }
+
+    _sqRingSize = params.sq_off.array + (params.sq_entries * sizeof(unsigned));
+    _cqRingSize = params.cq_off.cqes + (params.cq_entries * sizeof(io_uring_cqe));
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        _sqRingSize = _cqRingSize = qMax(_sqRingSize, _cqRingSize);
+    }
+
+    void *mapping = mmap(nullptr, _sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQ_RING);
+    if (mapping == MAP_FAILED) {
+        const int error = errno;
+        close();
+        errno = error;
+        return false;
+    }
+    _sqRing = mapping;
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        _cqRing = _sqRing;
+    } else {
+        mapping = mmap(nullptr, _cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_CQ_RING);
+        if (mapping == MAP_FAILED) {
+            const int error = errno;
+            close();
+            errno = error;
+            return false;
+        }
+        _cqRing = mapping;
+    }
+
+    _sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    mapping = mmap(nullptr, _sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQES);
+    if (mapping == MAP_FAILED) {
+        const int error = errno;
+        close();
+        errno = error;
+        return false;
+    }
+    _sqes = static_cast<io_uring_sqe*>(mapping);
+
+    char *const sq = static_cast<char*>(_sqRing);
+    _sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    _sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    _sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    _sqEntries = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_entries);
+    _sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    char *const cq = static_cast<char*>(_cqRing);
+    _cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    _cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    _cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    _cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    _localTail = *_sqTail;
+
+    _eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if ((_eventFd < 0) || (registerResource(IORING_REGISTER_EVENTFD, &_eventFd, 1) < 0)) {
+        const int error = errno;
+        close();
+        errno = error;
+        return false;
+    }
+
+    return true;
+}
+
+void IoUring::close()
+{
+    if (_fd >= 0) {
+        // Closing the ring cancels whatever is still in flight
+        (void) ::close(_fd);
+        _fd = -1;
+    }
+    if (_eventFd >= 0) {
+        (void) ::close(_eventFd);
+        _eventFd = -1;
+    }
+    if (_sqes) {
+        (void) munmap(_sqes, _sqesSize);
+        _sqes = nullptr;
+    }
+    if (_cqRing && (_cqRing != _sqRing)) {
+        (void) munmap(_cqRing, _cqRingSize);
+    }
+    _cqRing = nullptr;
+    if (_sqRing) {
+        (void) munmap(_sqRing, _sqRingSize);
+        _sqRing = nullptr;
+    }
+    _sqHead = _sqTail = _sqMask = _sqEntries = _sqArray = nullptr;
+    _cqHead = _cqTail = _cqMask = nullptr;
+    _cqes = nullptr;
+    _localTail = 0;
+}
+
+int IoUring::registerResource(unsigned opcode, const void *arg, unsigned count)
+{
+    return static_cast<int>(syscall(__NR_io_uring_register, _fd, opcode, arg, count));
+}
+
+io_uring_sqe *IoUring::nextSqe()
+{
+    if ((_localTail - _loadAcquire(_sqHead)) >= *_sqEntries) {
+        return nullptr;
+    }
+
+    const unsigned index = _localTail & *_sqMask;
+    io_uring_sqe *const sqe = &_sqes[index];
+    (void) memset(sqe, 0, sizeof(*sqe));
+    _sqArray[index] = index;
+    _localTail++;
+    return sqe;
+}
+
+bool IoUring::submit()
+{
+    const unsigned count = _localTail - *_sqTail;
+    if (count == 0) {
+        return true;
+    }
+
+    _storeRelease(_sqTail, _localTail);
+    long submitted;
+    do {
+        submitted = syscall(__NR_io_uring_enter, _fd, count, 0, 0, nullptr, 0);
+    } while ((submitted < 0) && (errno == EINTR));
+
+    if ((submitted >= 0) && (static_cast<unsigned>(submitted) < count)) {
+        errno = EBUSY;
+    }
+    return (submitted == static_cast<long>(count));
+}
+
+void IoUring::_clearEventFd()
+{
+    uint64_t count;
+    (void) ::read(_eventFd, &count, sizeof(count));
+}
+
+#endif
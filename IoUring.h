@@ -0,0 +1,101 @@
+#pragma once
+
+#include <QtCore/QtGlobal>
+
+#if defined(Q_OS_LINUX) && __has_include(<linux/io_uring.h>)
+#define QGC_IO_URING_AVAILABLE 1
+#endif
+
+#ifdef QGC_IO_URING_AVAILABLE
+
+#include <linux/io_uring.h>
+
+#include <atomic>
+#include <cstddef>
+
+/// Submission and completion rings of one io_uring instance, set up on the raw syscalls so only
+/// <linux/io_uring.h> is needed, not liburing. Shared by the io_uring engines of the links, which only
+/// include it from their .cc files behind QGC_IO_URING_AVAILABLE. Completions raise eventFd().
+/// Not thread safe, the owning worker thread does all of it.
+class IoUring
+{
+public:
+    IoUring();
+    ~IoUring();
+
+    IoUring(const IoUring&) = delete;
+    IoUring &operator=(const IoUring&) = delete;
+
+    /// Sets up the rings and the completion eventfd
+    ///     @return false with errno set, the instance is closed then
+    bool open(unsigned entries, unsigned completionEntries);
+    void close();
+    bool isOpen() const { return (_fd >= 0); }
+
+    int fd() const { return _fd; }
+    /// Becomes readable when completions are waiting
+    int eventFd() const { return _eventFd; }
+
+    /// io_uring_register(), @return < 0 with errno set on failure
+    int registerResource(unsigned opcode, const void *arg, unsigned count);
+
+    /// Next submission entry, cleared, nullptr while unsubmitted entries fill the ring
+    io_uring_sqe *nextSqe();
+
+    /// Hands every entry got from nextSqe() since the last submit to the kernel in one syscall
+    ///     @return false with errno set when the kernel took fewer
+    bool submit();
+
+    /// Clears the eventfd and calls callback(const io_uring_cqe &cqe) for every completion in order.
+    /// A callback returning false stops the walk, the completions after it stay for the next reap.
+    ///     @return Number of completions consumed
+    template<typename Callback>
+    int reap(Callback &&callback)
+    {
+        _clearEventFd();
+
+        unsigned head = *_cqHead;
+        const unsigned tail = _loadAcquire(_cqTail);
+        int count = 0;
+        while (head != tail) {
+            const io_uring_cqe &cqe = _cqes[head & *_cqMask];
+            head++;
+            count++;
+            if (!callback(cqe)) {
+                break;
+            }
+        }
+        _storeRelease(_cqHead, head);
+        return count;
+    }
+
+private:
+    void _clearEventFd();
+
+    static unsigned _loadAcquire(const unsigned *p) { return reinterpret_cast<const std::atomic<unsigned>*>(p)->load(std::memory_order_acquire); }
+    static void _storeRelease(unsigned *p, unsigned value) { reinterpret_cast<std::atomic<unsigned>*>(p)->store(value, std::memory_order_release); }
+
+    int _fd = -1;
+    int _eventFd = -1;
+
+    void *_sqRing = nullptr;
+    size_t _sqRingSize = 0;
+    void *_cqRing = nullptr;
+    size_t _cqRingSize = 0;
+    io_uring_sqe *_sqes = nullptr;
+    size_t _sqesSize = 0;
+
+    unsigned *_sqHead = nullptr;
+    unsigned *_sqTail = nullptr;
+    unsigned *_sqMask = nullptr;
+    unsigned *_sqEntries = nullptr;
+    unsigned *_sqArray = nullptr;
+    unsigned *_cqHead = nullptr;
+    unsigned *_cqTail = nullptr;
+    unsigned *_cqMask = nullptr;
+    io_uring_cqe *_cqes = nullptr;
+
+    unsigned _localTail = 0;            ///< Entries handed out by nextSqe(), _sqTail once submitted
+};
+
+#endif
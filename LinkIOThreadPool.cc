@@ -0,0 +1,167 @@
+#include "LinkIOThreadPool.h"
+
+#include <QtCore/QSettings>
+#include <QtCore/QThread>
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    #include <QtCore/qapplicationstatic.h>
+    Q_APPLICATION_STATIC(LinkIOThreadPool, _linkIOThreadPoolInstance);
+#else
+    #include <QtCore/QGlobalStatic>
+    Q_GLOBAL_STATIC(LinkIOThreadPool, _linkIOThreadPoolInstance)
+#endif
+
+Q_LOGGING_CATEGORY(LinkIOThreadPoolLog, "qgc.comms.linkiothreadpool")
+
+LinkIOThreadPool::LinkIOThreadPool(QObject *parent)
+    : QObject(parent)
+{
+    QSettings settings;
+    _sharedThreadCount = qMax(0, settings.value(_threadCountKey, 0).toInt());
+    qCDebug(LinkIOThreadPoolLog) << "Shared I/O threads:" << _sharedThreadCount;
+}
+
+LinkIOThreadPool::~LinkIOThreadPool()
+{
+    for (const IOThread_t &ioThread : _shared) {
+        ioThread.anchor->deleteLater();
+        ioThread.thread->quit();
+        (void) ioThread.thread->wait();
+        delete ioThread.thread;
+    }
+}
+
+LinkIOThreadPool *LinkIOThreadPool::instance()
+{
+    return _linkIOThreadPoolInstance();
+}
+
+void LinkIOThreadPool::attach(QObject *worker, const QString &name, const std::function<void()> &setup)
+{
+    Q_ASSERT(!worker->parent());
+
+    if (!isShared()) {
+        QThread *const thread = new QThread();
+        thread->setObjectName(name);
+        (void) worker->moveToThread(thread);
+        (void) connect(thread, &QThread::started, worker, setup);
+        (void) connect(thread, &QThread::finished, worker, &QObject::deleteLater);
+        _dedicatedThreads.insert(worker, thread);
+        thread->start();
+        return;
+    }
+
+    if (_shared.isEmpty()) {
+        _startSharedThreads();
+    }
+
+    int index = 0;
+    for (int i = 1; i < _shared.size(); i++) {
+        if (_shared[i].workers < _shared[index].workers) {
+            index = i;
+        }
+    }
+
+    (void) worker->moveToThread(_shared[index].thread);
+    _shared[index].workers++;
+    _sharedWorkers.insert(worker, index);
+    (void) QMetaObject::invokeMethod(worker, setup, Qt::QueuedConnection);
+
+    qCDebug(LinkIOThreadPoolLog) << name << "pinned to" << _shared[index].thread->objectName() << load();
+}
+
+void LinkIOThreadPool::detach(QObject *worker, unsigned long timeoutMs)
+{
+    QThread *const dedicated = _dedicatedThreads.take(worker);
+    if (dedicated) {
+        dedicated->quit();
+        if (dedicated->wait(timeoutMs)) {
+            delete dedicated;
+        } else {
+            // Deleting a running QThread aborts, leave it to finish on its own
+            qCWarning(LinkIOThreadPoolLog) << "Failed to wait for" << dedicated->objectName() << "to close";
+            (void) connect(dedicated, &QThread::finished, dedicated, &QObject::deleteLater);
+        }
+        return;
+    }
+
+    const auto it = _sharedWorkers.constFind(worker);
+    if (it == _sharedWorkers.constEnd()) {
+        return;
+    }
+
+    const int index = it.value();
+    _sharedWorkers.erase(it);
+    _shared[index].workers--;
+
+    // Queued behind whatever the link already posted to the worker
+    (void) QMetaObject::invokeMethod(_shared[index].anchor, [worker] {
+        delete worker;
+    }, Qt::BlockingQueuedConnection);
+
+    _rebalance();
+}
+
+QList<int> LinkIOThreadPool::load() const
+{
+    QList<int> workers;
+    for (const IOThread_t &ioThread : _shared) {
+        workers.append(ioThread.workers);
+    }
+    return workers;
+}
+
+void LinkIOThreadPool::_startSharedThreads()
+{
+    for (int i = 0; i < _sharedThreadCount; i++) {
+        IOThread_t ioThread;
+        ioThread.thread = new QThread();
+        ioThread.thread->setObjectName(QStringLiteral("LinkIO_%1").arg(i));
+        ioThread.thread->setStackSize(_stackSize);
+        ioThread.anchor = new QObject();
+        (void) ioThread.anchor->moveToThread(ioThread.thread);
+        ioThread.thread->start();
+        _shared.append(ioThread);
+    }
+}
+
+void LinkIOThreadPool::_rebalance()
+{
+    int busiest = 0;
+    int idlest = 0;
+    for (int i = 1; i < _shared.size(); i++) {
+        if (_shared[i].workers > _shared[busiest].workers) {
+            busiest = i;
+        }
+        if (_shared[i].workers < _shared[idlest].workers) {
+            idlest = i;
+        }
+    }
+
+    if ((_shared[busiest].workers - _shared[idlest].workers) <= 1) {
+        return;
+    }
+
+    QObject *worker = nullptr;
+    for (auto it = _sharedWorkers.begin(); it != _sharedWorkers.end(); ++it) {
+        if (it.value() == busiest) {
+            worker = it.key();
+            it.value() = idlest;
+            break;
+        }
+    }
+    if (!worker) {
+        return;
+    }
+
+    // moveToThread() has to run on the thread the worker currently lives in. Its sockets, timers and
+    // pending events follow it.
+    QThread *const target = _shared[idlest].thread;
+    (void) QMetaObject::invokeMethod(_shared[busiest].anchor, [worker, target] {
+        (void) worker->moveToThread(target);
+    }, Qt::BlockingQueuedConnection);
+
+    _shared[busiest].workers--;
+    _shared[idlest].workers++;
+    qCDebug(LinkIOThreadPoolLog) << "Rebalanced" << load();
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+
+#include <climits>
+#include <functional>
+
+class QThread;
+
+Q_DECLARE_LOGGING_CATEGORY(LinkIOThreadPoolLog)
+
+/// Threads the link workers run on.
+/// By default every worker gets a dedicated thread, as before. With the "linkIOThreads" setting at N > 0,
+/// all workers share a fixed pool of N I/O threads instead: each thread's event dispatcher polls the
+/// sockets and ttys of every worker pinned to it, so dozens of links no longer mean dozens of threads,
+/// stacks and context switches. A worker is pinned to the least loaded thread when attached, and when a
+/// detach leaves the pool unbalanced a worker is migrated from the busiest thread to the idlest one.
+/// Only used from the main thread.
+class LinkIOThreadPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LinkIOThreadPool(QObject *parent = nullptr);
+    ~LinkIOThreadPool();
+
+    static LinkIOThreadPool *instance();
+
+    bool isShared() const { return (_sharedThreadCount > 0); }
+
+    /// Moves the parentless worker to its I/O thread and queues setup() there
+    ///     @param name Thread name when the worker gets a dedicated thread
+    void attach(QObject *worker, const QString &name, const std::function<void()> &setup);
+
+    /// Deletes the worker on its I/O thread and waits for it
+    ///     @param timeoutMs Longest wait for a dedicated thread to finish
+    void detach(QObject *worker, unsigned long timeoutMs = ULONG_MAX);
+
+    /// Number of workers pinned to each shared thread
+    QList<int> load() const;
+
+private:
+    struct IOThread_t {
+        QThread *thread = nullptr;
+        QObject *anchor = nullptr;      ///< Lives in thread, context for calls that must run there
+        int workers = 0;
+    };
+
+    void _startSharedThreads();
+    void _rebalance();
+
+    int _sharedThreadCount = 0;
+    QList<IOThread_t> _shared;
+    QHash<QObject*, int> _sharedWorkers;            ///< Worker -> index into _shared
+    QHash<QObject*, QThread*> _dedicatedThreads;
+
+    static constexpr const char *_threadCountKey = "linkIOThreads";
+    static constexpr uint _stackSize = 256 * 1024;
+};
@@ -0,0 +1,163 @@
+#include "MAVLinkChannel.h"
+
+#include <QtCore/QGlobalStatic>
+
+#include <algorithm>
+
+Q_LOGGING_CATEGORY(MAVLinkChannelLog, "qgc.comms.mavlinkchannel")
+
+Q_GLOBAL_STATIC(MAVLinkChannelPool, _mavlinkChannelPoolInstance)
+
+void MAVLinkChannel::reset()
+{
+    status = {};
+    status.flags |= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+    rxBuffer = {};
+    parser.reset();
+    parser.setSigningMutex(nullptr);
+}
+
+MAVLinkChannelPool::MAVLinkChannelPool()
+{
+    _tables.push_back(std::make_unique<BlockTable_t>(_initialTableSize));
+    _table.store(_tables.back().get(), std::memory_order_release);
+
+    // Channel 0 is what the mavlink_msg_*_pack() convenience functions use, keep it away from links
+    (void) allocate();
+}
+
+MAVLinkChannelPool *MAVLinkChannelPool::instance()
+{
+    return _mavlinkChannelPoolInstance();
+}
+
+MAVLinkChannel *MAVLinkChannelPool::allocate()
+{
+    QMutexLocker locker(&_mutex);
+
+    if (!_freeList) {
+        _grow();
+    }
+
+    MAVLinkChannel *const channel = _freeList;
+    _freeList = channel->_nextFree;
+    channel->_nextFree = nullptr;
+    _inUse++;
+
+    channel->reset();
+    qCDebug(MAVLinkChannelLog) << "allocate" << channel->id << "in use" << _inUse;
+    return channel;
+}
+
+void MAVLinkChannelPool::release(MAVLinkChannel *channel)
+{
+    if (!channel) {
+        return;
+    }
+
+    QMutexLocker locker(&_mutex);
+
+    // Don't leave signing or parse state behind for the next owner
+    channel->reset();
+    channel->_nextFree = _freeList;
+    _freeList = channel;
+    _inUse--;
+    qCDebug(MAVLinkChannelLog) << "release" << channel->id << "in use" << _inUse;
+}
+
+MAVLinkChannel *MAVLinkChannelPool::channel(uint32_t id) const
+{
+    // Count first: _grow() publishes the table before the count, so any table loaded after holds the block
+    const uint32_t block = id / _blockSize;
+    if (block >= _blockCount.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+
+    return &_table.load(std::memory_order_acquire)->blocks[block][id % _blockSize];
+}
+
+uint32_t MAVLinkChannelPool::capacity() const
+{
+    return _blockCount.load(std::memory_order_acquire) * _blockSize;
+}
+
+uint32_t MAVLinkChannelPool::inUse() const
+{
+    QMutexLocker locker(&_mutex);
+    return _inUse;
+}
+
+int MAVLinkChannelPool::allocateSigningLinkId()
+{
+    QMutexLocker locker(&_mutex);
+
+    for (int linkId = 0; linkId < maxSigningLinkIds; linkId++) {
+        if (!_signingLinkIds.test(linkId)) {
+            _signingLinkIds.set(linkId);
+            return linkId;
+        }
+    }
+
+    return -1;
+}
+
+void MAVLinkChannelPool::releaseSigningLinkId(int linkId)
+{
+    if ((linkId < 0) || (linkId >= maxSigningLinkIds)) {
+        return;
+    }
+
+    QMutexLocker locker(&_mutex);
+    _signingLinkIds.reset(linkId);
+}
+
+void MAVLinkChannelPool::_grow()
+{
+    const uint32_t firstId = static_cast<uint32_t>(_blocks.size()) * _blockSize;
+    std::unique_ptr<MAVLinkChannel[]> block(new MAVLinkChannel[_blockSize]);
+
+    // Chain back to front so the lowest ids are handed out first
+    for (uint32_t i = _blockSize; i-- > 0;) {
+        block[i].id = firstId + i;
+        block[i]._nextFree = _freeList;
+        _freeList = &block[i];
+    }
+
+    const uint32_t blockCount = static_cast<uint32_t>(_blocks.size());
+    BlockTable_t *table = _tables.back().get();
+    if (blockCount == table->capacity) {
+        std::unique_ptr<BlockTable_t> bigger = std::make_unique<BlockTable_t>(table->capacity * 2);
+        std::copy(table->blocks.get(), table->blocks.get() + blockCount, bigger->blocks.get());
+        table = bigger.get();
+        _tables.push_back(std::move(bigger));
+        _table.store(table, std::memory_order_release);
+    }
+    table->blocks[blockCount] = block.get();
+
+    _blocks.push_back(std::move(block));
+    _blockCount.store(blockCount + 1, std::memory_order_release);
+    qCDebug(MAVLinkChannelLog) << "grown to" << (firstId + _blockSize) << "channels";
+}
+
+/// Legacy channel index API of the MAVLink library, only the first 256 pool channels are reachable this way
+static MAVLinkChannel *_legacyChannel(uint8_t chan)
+{
+    const MAVLinkChannelPool *const pool = MAVLinkChannelPool::instance();
+    return pool ? pool->channel(chan) : nullptr;
+}
+
+#ifdef MAVLINK_GET_CHANNEL_STATUS
+mavlink_status_t *mavlink_get_channel_status(uint8_t chan)
+{
+    MAVLinkChannel *const channel = _legacyChannel(chan);
+    return channel ? &channel->status : nullptr;
+}
+#endif
+
+#ifdef MAVLINK_GET_CHANNEL_BUFFER
+mavlink_message_t *mavlink_get_channel_buffer(uint8_t chan)
+{
+    MAVLinkChannel *const channel = _legacyChannel(chan);
+    return channel ? &channel->rxBuffer : nullptr;
+}
+#endif
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QMutex>
+
+#include <atomic>
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "MAVLinkLib.h"
+#include "MAVLinkFrameParser.h"
+#include "MAVLinkFrameView.h"
+
+Q_DECLARE_LOGGING_CATEGORY(MAVLinkChannelLog)
+
+/// Complete MAVLink parse and pack state of one stream: channel status (sequence numbers, signing,
+/// statistics), the mavlink_parse_char_buffer() receive buffer and the bulk frame parser.
+/// Pass &status / &rxBuffer to the *_status / *_buffer variants of the MAVLink API instead of a channel index.
+struct MAVLinkChannel
+{
+    MAVLinkChannel() : parser(&status) {}
+    MAVLinkChannel(const MAVLinkChannel&) = delete;
+    MAVLinkChannel &operator=(const MAVLinkChannel&) = delete;
+
+    /// Returns the channel to its freshly allocated state
+    void reset();
+
+    /// Runs data through the frame parser and calls callback(const MAVLinkFrameView &frame) for every
+    /// valid frame. A chunk holding exactly one frame is shared as is, otherwise each frame is sliced out once.
+    ///     @return Number of frames delivered
+    template<typename Callback>
+    int frame(const QByteArray &data, Callback &&callback)
+    {
+        const uint8_t *const bytes = reinterpret_cast<const uint8_t*>(data.constData());
+        return parser.parse(bytes, data.size(), [&data, bytes, &callback](const uint8_t *frame, size_t frameLength) {
+            if ((frame == bytes) && (frameLength == static_cast<size_t>(data.size()))) {
+                callback(MAVLinkFrameView(data));
+            } else {
+                callback(MAVLinkFrameView(QByteArray(reinterpret_cast<const char*>(frame), static_cast<int>(frameLength))));
+            }
+        });
+    }
+
+    uint32_t id = 0;                    ///< Pool index, stable for the lifetime of the pool
+    mavlink_status_t status{};
+    mavlink_message_t rxBuffer{};
+    MAVLinkFrameParser parser;
+
+private:
+    friend class MAVLinkChannelPool;
+    MAVLinkChannel *_nextFree = nullptr;
+};
+
+/// Growable pool of MAVLinkChannel. Channels are created in fixed size blocks so their addresses stay
+/// valid while the pool grows, and recycled through an intrusive free list, so allocate() and release()
+/// are O(1) whatever the number of links or remote senders.
+/// Blocks are published through an append-only block table, so channel() takes no lock: the legacy
+/// channel index API behind every mavlink_msg_*_pack_chan() call runs on it. The mutex only serializes
+/// allocate() and release().
+class MAVLinkChannelPool
+{
+public:
+    MAVLinkChannelPool();
+
+    static MAVLinkChannelPool *instance();
+
+    /// Never fails, the pool grows by a block when no channel is free
+    MAVLinkChannel *allocate();
+    void release(MAVLinkChannel *channel);
+
+    /// Lock free, any thread
+    ///     @return Channel with the given id, nullptr if the pool never grew that far
+    MAVLinkChannel *channel(uint32_t id) const;
+
+    uint32_t capacity() const;
+    uint32_t inUse() const;
+
+    /// 8 bit link id carried in the signatures of a signed link, unique among the links signing at once.
+    /// Channel ids can't serve: the pool grows past 256 and two links would sign as one stream.
+    ///     @return -1: all maxSigningLinkIds are in use
+    int allocateSigningLinkId();
+    void releaseSigningLinkId(int linkId);
+
+    static constexpr int maxSigningLinkIds = 256;
+
+private:
+    /// Block pointers, only ever appended to. Replaced by a copy twice the size when full, the old one
+    /// stays alive for readers that still hold it.
+    struct BlockTable_t {
+        explicit BlockTable_t(uint32_t capacity_) : capacity(capacity_), blocks(new MAVLinkChannel*[capacity_]()) {}
+
+        const uint32_t capacity;
+        std::unique_ptr<MAVLinkChannel*[]> blocks;
+    };
+
+    void _grow();
+
+    static constexpr uint32_t _blockSize = 32;
+    static constexpr uint32_t _initialTableSize = 8;   ///< Blocks, the 256 channels the legacy API reaches
+
+    mutable QMutex _mutex;
+    std::vector<std::unique_ptr<MAVLinkChannel[]>> _blocks;
+    std::vector<std::unique_ptr<BlockTable_t>> _tables;  ///< Current one last
+    std::atomic<const BlockTable_t*> _table{nullptr};
+    std::atomic<uint32_t> _blockCount{0};               ///< Published after the block went into _table
+    MAVLinkChannel *_freeList = nullptr;
+    uint32_t _inUse = 0;
+    std::bitset<maxSigningLinkIds> _signingLinkIds;
+};
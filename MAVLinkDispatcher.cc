@@ -0,0 +1,108 @@
+#include "MAVLinkDispatcher.h"
+#include "MAVLinkFrameView.h"
+
+#include <QtCore/QGlobalStatic>
+
+#include <algorithm>
+
+Q_LOGGING_CATEGORY(MAVLinkDispatcherLog, "qgc.comms.mavlinkdispatcher")
+
+Q_GLOBAL_STATIC(MAVLinkDispatcher, _mavlinkDispatcherInstance)
+
+MAVLinkDispatcher *MAVLinkDispatcher::instance()
+{
+    return _mavlinkDispatcherInstance();
+}
+
+MAVLinkDispatcher::SubscriptionId MAVLinkDispatcher::subscribe(uint32_t msgid, MessageHandler handler)
+{
+    return subscribe(msgid, msgid, std::move(handler));
+}
+
+MAVLinkDispatcher::SubscriptionId MAVLinkDispatcher::subscribe(uint32_t msgid, MessageQueue *queue)
+{
+    return subscribe(msgid, msgid, queue);
+}
+
+MAVLinkDispatcher::SubscriptionId MAVLinkDispatcher::subscribe(uint32_t firstMsgid, uint32_t lastMsgid, MessageHandler handler)
+{
+    Subscriber_t subscriber;
+    subscriber.handler = std::move(handler);
+    return _subscribe(firstMsgid, lastMsgid, subscriber);
+}
+
+MAVLinkDispatcher::SubscriptionId MAVLinkDispatcher::subscribe(uint32_t firstMsgid, uint32_t lastMsgid, MessageQueue *queue)
+{
+    Subscriber_t subscriber;
+    subscriber.queue = queue;
+    return _subscribe(firstMsgid, lastMsgid, subscriber);
+}
+
+MAVLinkDispatcher::SubscriptionId MAVLinkDispatcher::_subscribe(uint32_t firstMsgid, uint32_t lastMsgid, const Subscriber_t &subscriber)
+{
+    Subscriber_t entry = subscriber;
+    entry.id = _nextId;
+
+    // entries are sorted by msgid, so the range maps onto a contiguous run of dense indices
+    const mavlink_msg_entry_t *const begin = std::begin(MAVLinkMessageTable::entries);
+    const mavlink_msg_entry_t *const end = std::end(MAVLinkMessageTable::entries);
+    const mavlink_msg_entry_t *first = std::lower_bound(begin, end, firstMsgid, [](const mavlink_msg_entry_t &e, uint32_t msgid) {
+        return e.msgid < msgid;
+    });
+
+    int count = 0;
+    for (; (first != end) && (first->msgid <= lastMsgid); ++first) {
+        _subscribers[first - begin].push_back(entry);
+        count++;
+    }
+
+    if (count == 0) {
+        qCWarning(MAVLinkDispatcherLog) << "No dialect message in" << firstMsgid << "-" << lastMsgid;
+        return invalidSubscription;
+    }
+
+    qCDebug(MAVLinkDispatcherLog) << "subscribe" << entry.id << firstMsgid << "-" << lastMsgid << count << "messages";
+    return _nextId++;
+}
+
+void MAVLinkDispatcher::unsubscribe(SubscriptionId id)
+{
+    if (id == invalidSubscription) {
+        return;
+    }
+
+    for (std::vector<Subscriber_t> &subscribers : _subscribers) {
+        subscribers.erase(std::remove_if(subscribers.begin(), subscribers.end(), [id](const Subscriber_t &subscriber) {
+            return subscriber.id == id;
+        }), subscribers.end());
+    }
+}
+
+bool MAVLinkDispatcher::isSubscribed(uint32_t msgid) const
+{
+    const int index = MAVLinkMessageTable::denseIndex(msgid);
+    return (index >= 0) && !_subscribers[index].empty();
+}
+
+void MAVLinkDispatcher::dispatch(LinkInterface *link, const MAVLinkFrameView &frame)
+{
+    const int index = MAVLinkMessageTable::denseIndex(frame.msgid());
+    if ((index < 0) || _subscribers[index].empty()) {
+        return;
+    }
+
+    mavlink_message_t message;
+    if (!frame.decode(message)) {
+        return;
+    }
+
+    for (const Subscriber_t &subscriber : _subscribers[index]) {
+        if (subscriber.queue) {
+            if (!subscriber.queue->push(message)) {
+                qCDebug(MAVLinkDispatcherLog) << "Queue full, dropped" << message.msgid << "for" << subscriber.id;
+            }
+        } else {
+            subscriber.handler(link, message);
+        }
+    }
+}
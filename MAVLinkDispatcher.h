@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QtCore/QLoggingCategory>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "MAVLinkLib.h"
+#include "MAVLinkMessageTable.h"
+#include "SPSCQueue.h"
+
+Q_DECLARE_LOGGING_CATEGORY(MAVLinkDispatcherLog)
+
+class LinkInterface;
+class MAVLinkFrameView;
+
+/// Delivers received messages only to the consumers registered for their msgid.
+/// Subscriptions live in a flat array indexed by the dense metadata index of MAVLinkMessageTable, so a
+/// frame nobody subscribed to costs one index lookup, and a subscribed frame is unpacked once no matter
+/// how many consumers it has. Consumers get a direct callback on the router thread, or a lock-free
+/// queue they drain from their own thread.
+/// Subscribing, unsubscribing and dispatching must all happen on the router (main) thread, and
+/// handlers must not (un)subscribe from within a dispatch.
+class MAVLinkDispatcher
+{
+public:
+    typedef std::function<void(LinkInterface *link, const mavlink_message_t &message)> MessageHandler;
+    /// Single consumer queue, filled from the router thread
+    typedef SPSCQueue<mavlink_message_t> MessageQueue;
+    typedef int SubscriptionId;
+
+    static constexpr SubscriptionId invalidSubscription = -1;
+
+    static MAVLinkDispatcher *instance();
+
+    /// @return invalidSubscription if msgid is not part of the dialect
+    SubscriptionId subscribe(uint32_t msgid, MessageHandler handler);
+    SubscriptionId subscribe(uint32_t msgid, MessageQueue *queue);
+
+    /// Subscribes to every dialect message in [firstMsgid, lastMsgid]
+    ///     @return invalidSubscription if the range holds no dialect message
+    SubscriptionId subscribe(uint32_t firstMsgid, uint32_t lastMsgid, MessageHandler handler);
+    SubscriptionId subscribe(uint32_t firstMsgid, uint32_t lastMsgid, MessageQueue *queue);
+
+    void unsubscribe(SubscriptionId id);
+
+    bool isSubscribed(uint32_t msgid) const;
+
+    /// Unpacks the frame and hands it to the subscribers of its msgid, if any
+    void dispatch(LinkInterface *link, const MAVLinkFrameView &frame);
+
+private:
+    struct Subscriber_t {
+        SubscriptionId id = invalidSubscription;
+        MessageHandler handler;
+        MessageQueue *queue = nullptr;
+    };
+
+    SubscriptionId _subscribe(uint32_t firstMsgid, uint32_t lastMsgid, const Subscriber_t &subscriber);
+
+    std::vector<Subscriber_t> _subscribers[MAVLinkMessageTable::entryCount];
+    SubscriptionId _nextId = 0;
+};
@@ -0,0 +1,256 @@
+#include "MAVLinkFrameParser.h"
+#include "MAVLinkMessageTable.h"
+
+#include <QtCore/QtAlgorithms>
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MAVLINK_FRAME_PARSER_SSE2
+#endif
+
+Q_LOGGING_CATEGORY(MAVLinkFrameParserLog, "qgc.comms.mavlinkframeparser")
+
+MAVLinkFrameParser::MAVLinkFrameParser(mavlink_status_t *status)
+    : _status(status)
+{
+}
+
+int MAVLinkFrameParser::_parse(const uint8_t *data, size_t length, FrameHandler handler, void *context)
+{
+    int frameCount = 0;
+    size_t offset = 0;
+
+    if (_pendingLength > 0) {
+        // Complete the carried over frame from the head of the new chunk. At most one maximum sized
+        // packet is appended, which is enough to finish any frame starting inside the carried bytes.
+        const size_t appended = qMin(length, sizeof(_pending) - _pendingLength);
+        (void) memcpy(&_pending[_pendingLength], data, appended);
+
+        const size_t scratchLength = _pendingLength + appended;
+        const size_t consumed = _scan(_pending, scratchLength, handler, context, frameCount);
+        if (consumed < _pendingLength) {
+            // Still incomplete, which can only happen when the whole chunk was appended
+            Q_ASSERT(appended == length);
+            _pendingLength = scratchLength - consumed;
+            (void) memmove(_pending, &_pending[consumed], _pendingLength);
+            return frameCount;
+        }
+
+        offset = consumed - _pendingLength;
+        _pendingLength = 0;
+    }
+
+    const size_t consumed = _scan(&data[offset], length - offset, handler, context, frameCount);
+    const size_t remaining = length - offset - consumed;
+    Q_ASSERT(remaining < MAVLINK_MAX_PACKET_LEN);
+    if (remaining > 0) {
+        (void) memcpy(_pending, &data[offset + consumed], remaining);
+        _pendingLength = remaining;
+    }
+
+    return frameCount;
+}
+
+size_t MAVLinkFrameParser::_scan(const uint8_t *data, size_t length, FrameHandler handler, void *context, int &frameCount)
+{
+    size_t pos = 0;
+
+    while (pos < length) {
+        const uint8_t *const frame = _findStartMarker(&data[pos], &data[length]);
+        pos = frame - data;
+        if (pos >= length) {
+            break;
+        }
+
+        const size_t available = length - pos;
+        const bool mavlink1 = (frame[0] == MAVLINK_STX_MAVLINK1);
+        const uint16_t headerLength = mavlink1 ? (MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1) : MAVLINK_NUM_HEADER_BYTES;
+        if (available < headerLength) {
+            break;
+        }
+
+        uint8_t signatureLength = 0;
+        if (!mavlink1) {
+            const uint8_t incompatFlags = frame[2];
+            if ((incompatFlags & ~MAVLINK_IFLAG_MASK) != 0) {
+                _parseError();
+                pos++;
+                continue;
+            }
+            if (incompatFlags & MAVLINK_IFLAG_SIGNED) {
+                signatureLength = MAVLINK_SIGNATURE_BLOCK_LEN;
+            }
+        }
+
+        const size_t frameLength = headerLength + frame[1] + MAVLINK_NUM_CHECKSUM_BYTES + signatureLength;
+        if (available < frameLength) {
+            break;
+        }
+
+        switch (_deliverFrame(frame, frameLength, headerLength, handler, context)) {
+        case FrameDelivered:
+            frameCount++;
+            pos += frameLength;
+            break;
+        case FrameRejected:
+            pos += frameLength;
+            break;
+        case FrameInvalid:
+        default:
+            pos++;
+            break;
+        }
+    }
+
+    return pos;
+}
+
+MAVLinkFrameParser::FrameResult_t MAVLinkFrameParser::_deliverFrame(const uint8_t *frame, size_t frameLength, uint16_t headerLength, FrameHandler handler, void *context)
+{
+    const bool mavlink1 = (headerLength != MAVLINK_NUM_HEADER_BYTES);
+    const uint8_t payloadLength = frame[1];
+    const uint32_t msgid = mavlink1 ? frame[5] : (frame[7] | (frame[8] << 8) | (static_cast<uint32_t>(frame[9]) << 16));
+
+    const mavlink_msg_entry_t *const entry = MAVLinkMessageTable::entry(msgid);
+    if (!entry) {
+        // Unknown messages can't be CRC checked, same as mavlink_frame_char_buffer
+        _parseError();
+        return FrameInvalid;
+    }
+
+    const uint8_t *const payload = &frame[headerLength];
+    const uint8_t *const ck = &payload[payloadLength];
+
+    uint16_t checksum = crc_calculate(&frame[1], headerLength - 1 + payloadLength);
+    crc_accumulate(entry->crc_extra, &checksum);
+    if ((ck[0] != (checksum & 0xFF)) || (ck[1] != (checksum >> 8))) {
+        qCDebug(MAVLinkFrameParserLog) << "Bad CRC for msgid" << msgid;
+        _parseError();
+        return FrameInvalid;
+    }
+
+    if (_status && _status->signing) {
+        // Signing may be reconfigured from another thread, only trust what is read under the lock
+        QMutexLocker locker(signingMutex());
+        mavlink_signing_t *const signing = _status->signing;
+
+        // signing is nullptr when it was turned off meanwhile
+        bool signatureOk = true;
+        const bool isSigned = !mavlink1 && (frame[2] & MAVLINK_IFLAG_SIGNED);
+        if (signing && isSigned) {
+#ifndef MAVLINK_NO_SIGNATURE_CHECK
+            signatureOk = mavlink_signature_check_frame(signing, _status->signing_streams, frame, static_cast<uint16_t>(frameLength));
+#endif
+        } else if (signing) {
+            signatureOk = false;
+        }
+
+        if (!signatureOk) {
+            const mavlink_accept_unsigned_t acceptUnsigned = signing->accept_unsigned_callback;
+            if (!acceptUnsigned || !acceptUnsigned(_status, msgid)) {
+                locker.unlock();
+                _parseError();
+                return FrameRejected;
+            }
+        }
+    }
+
+    if (_status) {
+        if (mavlink1) {
+            _status->flags |= MAVLINK_STATUS_FLAG_IN_MAVLINK1;
+        } else {
+            _status->flags &= ~MAVLINK_STATUS_FLAG_IN_MAVLINK1;
+        }
+        _status->current_rx_seq = frame[mavlink1 ? 2 : 4];
+        if (_status->packet_rx_success_count == 0) {
+            _status->packet_rx_drop_count = 0;
+        }
+        _status->packet_rx_success_count++;
+    }
+
+    handler(context, frame, frameLength);
+
+    return FrameDelivered;
+}
+
+bool MAVLinkFrameParser::decode(const uint8_t *frame, size_t frameLength, mavlink_message_t &message)
+{
+    const bool mavlink1 = (frame[0] == MAVLINK_STX_MAVLINK1);
+    const uint16_t headerLength = mavlink1 ? (MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1) : MAVLINK_NUM_HEADER_BYTES;
+    const uint8_t payloadLength = frame[1];
+    if (frameLength < (headerLength + payloadLength + MAVLINK_NUM_CHECKSUM_BYTES)) {
+        return false;
+    }
+
+    message.magic = frame[0];
+    message.len = payloadLength;
+    if (mavlink1) {
+        message.incompat_flags = 0;
+        message.compat_flags = 0;
+        message.seq = frame[2];
+        message.sysid = frame[3];
+        message.compid = frame[4];
+        message.msgid = frame[5];
+    } else {
+        message.incompat_flags = frame[2];
+        message.compat_flags = frame[3];
+        message.seq = frame[4];
+        message.sysid = frame[5];
+        message.compid = frame[6];
+        message.msgid = frame[7] | (frame[8] << 8) | (static_cast<uint32_t>(frame[9]) << 16);
+    }
+
+    // Zero-fill truncated payloads up to the full message length, as the byte parser does
+    const uint8_t *const payload = &frame[headerLength];
+    char *const messagePayload = _MAV_PAYLOAD_NON_CONST(&message);
+    (void) memcpy(messagePayload, payload, payloadLength);
+    const mavlink_msg_entry_t *const entry = MAVLinkMessageTable::entry(message.msgid);
+    if (entry && (payloadLength < entry->max_msg_len)) {
+        (void) memset(&messagePayload[payloadLength], 0, entry->max_msg_len - payloadLength);
+    }
+
+    const uint8_t *const ck = &payload[payloadLength];
+    message.ck[0] = ck[0];
+    message.ck[1] = ck[1];
+    message.checksum = ck[0] | (ck[1] << 8);
+
+    if ((message.incompat_flags & MAVLINK_IFLAG_SIGNED) && (frameLength >= (headerLength + payloadLength + MAVLINK_NUM_CHECKSUM_BYTES + MAVLINK_SIGNATURE_BLOCK_LEN))) {
+        (void) memcpy(message.signature, &ck[MAVLINK_NUM_CHECKSUM_BYTES], MAVLINK_SIGNATURE_BLOCK_LEN);
+    }
+
+    return true;
+}
+
+void MAVLinkFrameParser::_parseError()
+{
+    if (_status) {
+        _mav_parse_error(_status);
+    }
+}
+
+const uint8_t *MAVLinkFrameParser::_findStartMarker(const uint8_t *begin, const uint8_t *end)
+{
+#ifdef MAVLINK_FRAME_PARSER_SSE2
+    const __m128i stx = _mm_set1_epi8(static_cast<char>(MAVLINK_STX));
+    const __m128i stx1 = _mm_set1_epi8(static_cast<char>(MAVLINK_STX_MAVLINK1));
+    while ((end - begin) >= 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+        const __m128i matches = _mm_or_si128(_mm_cmpeq_epi8(chunk, stx), _mm_cmpeq_epi8(chunk, stx1));
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(matches));
+        if (mask != 0) {
+            return begin + qCountTrailingZeroBits(mask);
+        }
+        begin += 16;
+    }
+#endif
+
+    for (; begin < end; ++begin) {
+        if ((*begin == MAVLINK_STX) || (*begin == MAVLINK_STX_MAVLINK1)) {
+            return begin;
+        }
+    }
+
+    return end;
+}
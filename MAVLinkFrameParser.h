@@ -0,0 +1,78 @@
+#pragma once
+
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QMutex>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "MAVLinkLib.h"
+
+Q_DECLARE_LOGGING_CATEGORY(MAVLinkFrameParserLog)
+
+/// Buffer oriented replacement for the mavlink_frame_char_buffer() byte state machine.
+/// A whole datagram or serial chunk is scanned for start markers and every candidate frame
+/// is validated (length, incompat flags, CRC, signature) over the complete span in one go.
+/// A trailing partial frame is carried over and completed by the next call.
+class MAVLinkFrameParser
+{
+public:
+    explicit MAVLinkFrameParser(mavlink_status_t *status = nullptr);
+
+    /// Channel status used for rx statistics and signing. Must stay valid while parsing.
+    void setStatus(mavlink_status_t *status) { _status = status; }
+    mavlink_status_t *status() const { return _status; }
+
+    /// Drops any partially received frame
+    void reset() { _pendingLength = 0; }
+
+    /// Extracts all complete frames contained in data. Frames are validated but not unpacked, use decode()
+    /// or MAVLinkFrameView when the payload is needed.
+    ///     @param callback Called as callback(const uint8_t *frame, size_t frameLength) for every valid frame.
+    ///                     frame points at the exact received wire bytes, signature included, and is only valid
+    ///                     for the duration of the call.
+    ///     @return Number of valid frames delivered to callback
+    template<typename Callback>
+    int parse(const uint8_t *data, size_t length, Callback &&callback)
+    {
+        auto thunk = [](void *context, const uint8_t *frame, size_t frameLength) {
+            (*static_cast<std::remove_reference_t<Callback>*>(context))(frame, frameLength);
+        };
+        return _parse(data, length, thunk, &callback);
+    }
+
+    /// Unpacks a complete frame into message the same way mavlink_frame_char_buffer() fills it.
+    /// No validation beyond the length is done.
+    ///     @return false: frameLength too short for the frame header
+    static bool decode(const uint8_t *frame, size_t frameLength, mavlink_message_t &message);
+
+    /// Lock of the signing state status() points at, owned by the link and shared only with its transmit
+    /// path and the sender channels of the same link, so signed links never wait on each other.
+    /// Must be set before status()->signing and outlive it.
+    void setSigningMutex(QMutex *mutex) { _signingMutex.store(mutex, std::memory_order_release); }
+    QMutex *signingMutex() const { return _signingMutex.load(std::memory_order_acquire); }
+
+private:
+    typedef void (*FrameHandler)(void *context, const uint8_t *frame, size_t frameLength);
+
+    enum FrameResult_t {
+        FrameDelivered,
+        FrameRejected,  ///< Well formed frame which failed signing, skip it as a whole
+        FrameInvalid    ///< Not a frame, resync on the next byte
+    };
+
+    int _parse(const uint8_t *data, size_t length, FrameHandler handler, void *context);
+    size_t _scan(const uint8_t *data, size_t length, FrameHandler handler, void *context, int &frameCount);
+    FrameResult_t _deliverFrame(const uint8_t *frame, size_t frameLength, uint16_t headerLength, FrameHandler handler, void *context);
+    void _parseError();
+
+    static const uint8_t *_findStartMarker(const uint8_t *begin, const uint8_t *end);
+
+    mavlink_status_t *_status = nullptr;
+    std::atomic<QMutex*> _signingMutex{nullptr};
+    size_t _pendingLength = 0;
+    /// Holds the carried over partial frame followed by the head of the next chunk
+    uint8_t _pending[MAVLINK_MAX_PACKET_LEN * 2];
+};
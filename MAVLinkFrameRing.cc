@@ -0,0 +1,37 @@
+#include "MAVLinkFrameRing.h"
+#include "WakeupNotifier.h"
+
+#include <cstring>
+
+MAVLinkFrameRing::MAVLinkFrameRing(size_t slotCount, QObject *parent)
+    : QObject(parent)
+    , _queue(slotCount)
+    , _notifier(new WakeupNotifier([this] { return !_queue.isEmpty(); }, this))
+{
+    (void) connect(_notifier, &WakeupNotifier::activated, this, &MAVLinkFrameRing::readyRead);
+}
+
+bool MAVLinkFrameRing::push(const uint8_t *frame, size_t frameLength)
+{
+    if (frameLength > MAVLINK_MAX_PACKET_LEN) {
+        (void) _oversizeCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Slot_t *const slot = _queue.beginPush();
+    if (!slot) {
+        return false;
+    }
+    slot->length = static_cast<uint16_t>(frameLength);
+    (void) memcpy(slot->data, frame, frameLength);
+    _queue.endPush();
+
+    _notifier->notify();
+
+    return true;
+}
+
+uint64_t MAVLinkFrameRing::wakeupCount() const
+{
+    return _notifier->wakeupCount();
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QtCore/QObject>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "MAVLinkLib.h"
+#include "SPSCQueue.h"
+
+class WakeupNotifier;
+
+/// Hands complete frames from one link worker thread (producer) to the router thread (consumer) without
+/// locks or allocations. Slots are preallocated and sized for the largest MAVLink frame, and the consumer
+/// is woken through a WakeupNotifier, so a burst of frames costs a single wakeup instead of one queued
+/// event per frame.
+/// The object must live in the consumer thread.
+class MAVLinkFrameRing : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MAVLinkFrameRing(size_t slotCount, QObject *parent = nullptr);
+
+    /// Producer thread. Copies the frame into the next free slot.
+    ///     @return false: ring full or frame too long, the frame is dropped and counted as overflow
+    bool push(const uint8_t *frame, size_t frameLength);
+
+    /// Consumer thread. Calls callback(const uint8_t *frame, size_t frameLength) for every queued frame.
+    ///     @return Number of frames drained
+    template<typename Callback>
+    int drain(Callback &&callback)
+    {
+        int count = 0;
+        for (const Slot_t *slot = _queue.front(); slot; slot = _queue.front()) {
+            callback(slot->data, static_cast<size_t>(slot->length));
+            _queue.popFront();
+            count++;
+        }
+        return count;
+    }
+
+    /// Consumer thread. Calls frame(size_t index, const uint8_t *frame, size_t frameLength) for every queued
+    /// frame, then batch(size_t count) once. The slots only go back to the producer after batch returned,
+    /// so every frame pointer of the call stays valid until then.
+    ///     @return Number of frames drained, at most capacity()
+    template<typename Frame, typename Batch>
+    int drainBatch(Frame &&frame, Batch &&batch)
+    {
+        const size_t count = _queue.readable();
+        if (count == 0) {
+            return 0;
+        }
+        for (size_t i = 0; i < count; i++) {
+            const Slot_t *const slot = _queue.at(i);
+            frame(i, slot->data, static_cast<size_t>(slot->length));
+        }
+        batch(count);
+        _queue.popFront(count);
+        return static_cast<int>(count);
+    }
+
+    size_t depth() const { return _queue.size(); }
+    size_t capacity() const { return _queue.capacity(); }
+    uint64_t overflowCount() const { return _queue.overflowCount() + _oversizeCount.load(std::memory_order_relaxed); }
+    uint64_t wakeupCount() const;
+
+signals:
+    /// Emitted on the consumer thread when frames are waiting, drain() them all
+    void readyRead();
+
+private:
+    struct Slot_t {
+        uint16_t length = 0;
+        uint8_t data[MAVLINK_MAX_PACKET_LEN];
+    };
+
+    SPSCQueue<Slot_t> _queue;
+    std::atomic<uint64_t> _oversizeCount{0};
+    WakeupNotifier *_notifier = nullptr;
+};
@@ -0,0 +1,44 @@
+#include "MAVLinkFrameView.h"
+#include "MAVLinkFrameParser.h"
+#include "MAVLinkMessageTable.h"
+
+uint32_t MAVLinkFrameView::msgid() const
+{
+    const uint8_t *const frame = data();
+    if (isMavlink1()) {
+        return frame[5];
+    }
+    return frame[7] | (frame[8] << 8) | (static_cast<uint32_t>(frame[9]) << 16);
+}
+
+uint8_t MAVLinkFrameView::targetSystem() const
+{
+    const mavlink_msg_entry_t *const entry = MAVLinkMessageTable::entry(msgid());
+    if (!entry || !(entry->flags & MAV_MSG_ENTRY_FLAG_HAVE_TARGET_SYSTEM)) {
+        return 0;
+    }
+    return _payloadByte(entry->target_system_ofs);
+}
+
+uint8_t MAVLinkFrameView::targetComponent() const
+{
+    const mavlink_msg_entry_t *const entry = MAVLinkMessageTable::entry(msgid());
+    if (!entry || !(entry->flags & MAV_MSG_ENTRY_FLAG_HAVE_TARGET_COMPONENT)) {
+        return 0;
+    }
+    return _payloadByte(entry->target_component_ofs);
+}
+
+uint8_t MAVLinkFrameView::_payloadByte(uint8_t offset) const
+{
+    // MAVLink 2 drops trailing zero bytes from the payload
+    return (offset < payloadLength()) ? payload()[offset] : 0;
+}
+
+bool MAVLinkFrameView::decode(mavlink_message_t &message) const
+{
+    if (!isValid()) {
+        return false;
+    }
+    return MAVLinkFrameParser::decode(data(), _frame.size(), message);
+}
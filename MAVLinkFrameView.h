@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QMetaType>
+
+#include <cstdint>
+
+#include "MAVLinkLib.h"
+
+/// Read-only view of one validated MAVLink frame as received on the wire.
+/// Routing only needs the header and the target fields, which are read straight out of the frame
+/// bytes. The full mavlink_message_t is only unpacked by decode() for consumers that need the payload.
+/// The bytes are implicitly shared, so copying a view (e.g. through a queued connection) is cheap.
+class MAVLinkFrameView
+{
+public:
+    MAVLinkFrameView() = default;
+    /// @param frame Complete frame, signature included. Must have passed MAVLinkFrameParser validation.
+    explicit MAVLinkFrameView(const QByteArray &frame) : _frame(frame) {}
+
+    bool isValid() const { return _frame.size() >= (MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1); }
+
+    /// Points the view at frame without copying, reusing the buffer header of the view when it already
+    /// borrowed one, so a view can be re-aimed at a new frame without allocating.
+    /// frame must stay alive for as long as the view, or any copy of it, is used.
+    void setRawFrame(const uint8_t *frame, size_t frameLength) { (void) _frame.setRawData(reinterpret_cast<const char*>(frame), static_cast<int>(frameLength)); }
+
+    /// Exact wire bytes of the frame
+    const QByteArray &bytes() const { return _frame; }
+    const uint8_t *data() const { return reinterpret_cast<const uint8_t*>(_frame.constData()); }
+    int size() const { return _frame.size(); }
+
+    bool isMavlink1() const { return data()[0] == MAVLINK_STX_MAVLINK1; }
+    uint8_t headerLength() const { return isMavlink1() ? (MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1) : MAVLINK_NUM_HEADER_BYTES; }
+    uint8_t payloadLength() const { return data()[1]; }
+    uint8_t incompatFlags() const { return isMavlink1() ? 0 : data()[2]; }
+    bool isSigned() const { return incompatFlags() & MAVLINK_IFLAG_SIGNED; }
+    uint8_t seq() const { return data()[isMavlink1() ? 2 : 4]; }
+    uint8_t sysid() const { return data()[isMavlink1() ? 3 : 5]; }
+    uint8_t compid() const { return data()[isMavlink1() ? 4 : 6]; }
+    uint32_t msgid() const;
+
+    /// Payload as sent, trailing zero bytes may be truncated on MAVLink 2
+    const uint8_t *payload() const { return data() + headerLength(); }
+
+    /// Target fields taken from the payload using the dialect metadata offsets
+    ///     @return 0 for broadcast or for messages without the field
+    uint8_t targetSystem() const;
+    uint8_t targetComponent() const;
+
+    /// Unpacks the full message
+    ///     @return false: view is not valid
+    bool decode(mavlink_message_t &message) const;
+
+private:
+    uint8_t _payloadByte(uint8_t offset) const;
+
+    QByteArray _frame;
+};
+
+Q_DECLARE_METATYPE(MAVLinkFrameView)
@@ -33,21 +33,30 @@ typedef enum : uint8_t {
 } mavlink_channel_t;
 #endif
 
+// Channel state lives in MAVLinkChannelPool, this only sizes the library's own (unused) fallback tables
 #define MAVLINK_COMM_NUM_BUFFERS 16
-#define MAVLINK_MAX_SIGNING_STREAMS MAVLINK_COMM_NUM_BUFFERS
+// Stream lookup is hashed, so size this for the number of remote (sysid, compid, link) tuples
+#define MAVLINK_MAX_SIGNING_STREAMS 256
 
 #include <mavlink_types.h>
 
-#define MAVLINK_EXTERNAL_RX_STATUS
-#ifdef MAVLINK_EXTERNAL_RX_STATUS
-extern mavlink_status_t m_mavlink_status[MAVLINK_COMM_NUM_BUFFERS];
-#endif
-
+// Channel index lookups resolve into MAVLinkChannelPool, see MAVLinkChannel.h
 #define MAVLINK_GET_CHANNEL_STATUS
 #ifdef MAVLINK_GET_CHANNEL_STATUS
 extern mavlink_status_t* mavlink_get_channel_status(uint8_t chan);
 #endif
 
+#define MAVLINK_GET_CHANNEL_BUFFER
+#ifdef MAVLINK_GET_CHANNEL_BUFFER
+extern mavlink_message_t* mavlink_get_channel_buffer(uint8_t chan);
+#endif
+
+// Direct indexed metadata lookup, see MAVLinkMessageTable.h
+#define MAVLINK_GET_MSG_ENTRY
+#ifdef MAVLINK_GET_MSG_ENTRY
+extern const mavlink_msg_entry_t *mavlink_get_msg_entry(uint32_t msgid);
+#endif
+
 // #define MAVLINK_NO_SIGN_PACKET
 // #define MAVLINK_NO_SIGNATURE_CHECK
 #define MAVLINK_USE_MESSAGE_INFO
@@ -0,0 +1,12 @@
+#include "MAVLinkMessageTable.h"
+
+static_assert(MAVLinkMessageTable::entry(MAVLINK_MSG_ID_HEARTBEAT)->crc_extra == MAVLINK_MSG_ID_HEARTBEAT_CRC, "Bad metadata index");
+static_assert(MAVLinkMessageTable::entry(MAVLINK_MSG_ID_COMMAND_LONG)->max_msg_len == MAVLINK_MSG_ID_COMMAND_LONG_LEN, "Bad metadata index");
+static_assert((MAVLinkMessageTable::entry(3) == nullptr) && (MAVLinkMessageTable::entry(0xFFFFFF) == nullptr), "Bad metadata index");
+
+#ifdef MAVLINK_GET_MSG_ENTRY
+const mavlink_msg_entry_t *mavlink_get_msg_entry(uint32_t msgid)
+{
+    return MAVLinkMessageTable::entry(msgid);
+}
+#endif
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "MAVLinkLib.h"
+
+/// Compile time message metadata index built from the dialect's MAVLINK_MESSAGE_CRCS table.
+/// The upper 16 bits of the 24 bit msgid select a 256 slot page through a small directory, the
+/// low byte selects the slot, so a lookup costs two loads instead of the bisection search in
+/// mavlink_get_msg_entry(). Also installed as the mavlink_get_msg_entry() implementation through
+/// MAVLINK_GET_MSG_ENTRY in MAVLinkLib.h.
+namespace MAVLinkMessageTable
+{
+    /// Dialect metadata, sorted by msgid
+    inline constexpr mavlink_msg_entry_t entries[] = MAVLINK_MESSAGE_CRCS;
+    inline constexpr size_t entryCount = sizeof(entries) / sizeof(entries[0]);
+
+    namespace Detail
+    {
+        constexpr uint32_t pageShift = 8;
+        constexpr size_t pageSize = 1 << pageShift;
+        constexpr size_t directorySize = (entries[entryCount - 1].msgid >> pageShift) + 1;
+
+        constexpr size_t usedPageCount()
+        {
+            size_t count = 0;
+            for (size_t i = 0; i < entryCount; i++) {
+                if ((i == 0) || ((entries[i].msgid >> pageShift) != (entries[i - 1].msgid >> pageShift))) {
+                    count++;
+                }
+            }
+            return count;
+        }
+
+        /// Page 0 is all empty and backs every unused directory slot
+        constexpr size_t pageCount = usedPageCount() + 1;
+
+        static_assert(pageCount <= UINT8_MAX, "Too many metadata pages for a uint8_t directory");
+        static_assert(entryCount < UINT16_MAX, "Too many messages for uint16_t slots");
+
+        struct Index_t {
+            uint8_t directory[directorySize];
+            uint16_t pages[pageCount][pageSize];   ///< dense index + 1, 0 for unknown msgid
+        };
+
+        constexpr Index_t buildIndex()
+        {
+            Index_t index{};
+            uint8_t page = 0;
+            for (size_t i = 0; i < entryCount; i++) {
+                const uint32_t msgid = entries[i].msgid;
+                if ((i == 0) || ((msgid >> pageShift) != (entries[i - 1].msgid >> pageShift))) {
+                    index.directory[msgid >> pageShift] = ++page;
+                }
+                index.pages[page][msgid & (pageSize - 1)] = static_cast<uint16_t>(i + 1);
+            }
+            return index;
+        }
+
+        inline constexpr Index_t index = buildIndex();
+    }
+
+    /// @return Position of msgid in entries, -1 for messages not in the dialect
+    constexpr int denseIndex(uint32_t msgid)
+    {
+        const uint32_t page = msgid >> Detail::pageShift;
+        if (page >= Detail::directorySize) {
+            return -1;
+        }
+        return static_cast<int>(Detail::index.pages[Detail::index.directory[page]][msgid & (Detail::pageSize - 1)]) - 1;
+    }
+
+    /// @return Metadata for msgid, nullptr for messages not in the dialect
+    constexpr const mavlink_msg_entry_t *entry(uint32_t msgid)
+    {
+        const int i = denseIndex(msgid);
+        return (i < 0) ? nullptr : &entries[i];
+    }
+}
@@ -0,0 +1,70 @@
+#include "MAVLinkRoutingTable.h"
+
+#include <algorithm>
+
+Q_LOGGING_CATEGORY(MAVLinkRoutingTableLog, "qgc.comms.mavlinkroutingtable")
+
+void MAVLinkRoutingTable::learn(LinkInterface *link, uint8_t sysid, uint8_t compid)
+{
+    std::vector<Route_t> &components = _systems[sysid];
+    for (Route_t &route : components) {
+        if (route.compid == compid) {
+            if (route.link != link) {
+                qCDebug(MAVLinkRoutingTableLog) << "Moved" << sysid << compid << "to" << link;
+                route.link = link;
+            }
+            return;
+        }
+    }
+
+    qCDebug(MAVLinkRoutingTableLog) << "Learned" << sysid << compid << "on" << link;
+    components.push_back({ compid, link });
+}
+
+bool MAVLinkRoutingTable::route(uint8_t targetSystem, uint8_t targetComponent, const LinkInterface *exclude, LinkList &links) const
+{
+    const std::vector<Route_t> &components = _systems[targetSystem];
+    if (components.empty()) {
+        return false;
+    }
+
+    if (targetComponent != 0) {
+        for (const Route_t &route : components) {
+            if (route.compid == targetComponent) {
+                _append(route.link, exclude, links);
+                return true;
+            }
+        }
+    }
+
+    // Whole system, or a component we have not heard yet
+    for (const Route_t &route : components) {
+        _append(route.link, exclude, links);
+    }
+    return true;
+}
+
+void MAVLinkRoutingTable::removeLink(const LinkInterface *link)
+{
+    for (std::vector<Route_t> &components : _systems) {
+        components.erase(std::remove_if(components.begin(), components.end(), [link](const Route_t &route) {
+            return route.link == link;
+        }), components.end());
+    }
+}
+
+int MAVLinkRoutingTable::routeCount() const
+{
+    size_t count = 0;
+    for (const std::vector<Route_t> &components : _systems) {
+        count += components.size();
+    }
+    return static_cast<int>(count);
+}
+
+void MAVLinkRoutingTable::_append(LinkInterface *link, const LinkInterface *exclude, LinkList &links)
+{
+    if ((link != exclude) && !links.contains(link)) {
+        links.append(link);
+    }
+}
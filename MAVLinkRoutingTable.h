@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QVarLengthArray>
+
+#include <cstdint>
+#include <vector>
+
+Q_DECLARE_LOGGING_CATEGORY(MAVLinkRoutingTableLog)
+
+class LinkInterface;
+
+/// Learns on which link every (sysid, compid) was last heard, so targeted frames can be delivered only
+/// to the links hosting their target, following the MAVLink routing rules:
+/// target_component 0 addresses every component of the system, and a component never heard from is
+/// reached through the links of its system.
+/// Components are kept in a small vector per sysid, a sender is nearly always found on the first compare.
+/// Main (router) thread only.
+class MAVLinkRoutingTable
+{
+public:
+    typedef QVarLengthArray<LinkInterface*, 4> LinkList;
+
+    /// Records that sysid/compid was heard on link
+    void learn(LinkInterface *link, uint8_t sysid, uint8_t compid);
+
+    /// Appends to links every link hosting the target, exclude (the source link) left out
+    ///     @return false: target system never heard from, links is unchanged
+    bool route(uint8_t targetSystem, uint8_t targetComponent, const LinkInterface *exclude, LinkList &links) const;
+
+    /// Forgets every route through link
+    void removeLink(const LinkInterface *link);
+
+    int routeCount() const;
+
+private:
+    struct Route_t {
+        uint8_t compid;
+        LinkInterface *link;
+    };
+
+    static void _append(LinkInterface *link, const LinkInterface *exclude, LinkList &links);
+
+    std::vector<Route_t> _systems[256];
+};
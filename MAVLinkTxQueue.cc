@@ -0,0 +1,68 @@
+#include "MAVLinkTxQueue.h"
+#include "WakeupNotifier.h"
+
+#include <cstring>
+
+MAVLinkTxQueue::MAVLinkTxQueue(size_t slotCount, QObject *parent)
+    : QObject(parent)
+    , _queue(slotCount)
+    , _notifier(new WakeupNotifier([this] { return !_queue.isEmpty(); }, this))
+{
+    (void) connect(_notifier, &WakeupNotifier::activated, this, &MAVLinkTxQueue::readyWrite);
+}
+
+bool MAVLinkTxQueue::push(const char *data, size_t length)
+{
+    if ((length > maxFrameLength) || !isOpen()) {
+        return false;
+    }
+
+    const bool queued = _queue.emplace([data, length](Slot_t &slot) {
+        slot.length = static_cast<uint16_t>(length);
+        (void) memcpy(slot.data, data, length);
+    });
+    if (queued) {
+        _notifier->notify();
+    }
+
+    return queued;
+}
+
+bool MAVLinkTxQueue::isUrgentFrame(const char *data, size_t length)
+{
+    const uint8_t *const frame = reinterpret_cast<const uint8_t*>(data);
+    uint32_t msgid;
+    if ((length > 5) && (frame[0] == MAVLINK_STX_MAVLINK1)) {
+        msgid = frame[5];
+    } else if ((length > 9) && (frame[0] == MAVLINK_STX)) {
+        msgid = frame[7] | (frame[8] << 8) | (static_cast<uint32_t>(frame[9]) << 16);
+    } else {
+        return true;
+    }
+
+    switch (msgid) {
+    case MAVLINK_MSG_ID_COMMAND_INT:
+    case MAVLINK_MSG_ID_COMMAND_LONG:
+    case MAVLINK_MSG_ID_COMMAND_ACK:
+    case MAVLINK_MSG_ID_COMMAND_CANCEL:
+    case MAVLINK_MSG_ID_SET_MODE:
+    case MAVLINK_MSG_ID_MANUAL_CONTROL:
+    case MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE:
+        return true;
+    default:
+        return false;
+    }
+}
+
+uint64_t MAVLinkTxQueue::takeOverflows()
+{
+    const uint64_t overflows = overflowCount();
+    const uint64_t count = overflows - _reportedOverflows;
+    _reportedOverflows = overflows;
+    return count;
+}
+
+uint64_t MAVLinkTxQueue::wakeupCount() const
+{
+    return _notifier->wakeupCount();
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <QtCore/QObject>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "MAVLinkLib.h"
+#include "MPSCQueue.h"
+
+class WakeupNotifier;
+
+/// Outbound frames of one link, written from any thread straight into preallocated slots and drained by
+/// the link worker. Replaces the QByteArray copy and the two queued events (caller -> link thread ->
+/// worker thread) of the generic write path for everything up to MAVLINK_MAX_PACKET_LEN bytes.
+/// The object must live in the worker thread.
+class MAVLinkTxQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MAVLinkTxQueue(size_t slotCount, QObject *parent = nullptr);
+
+    static constexpr size_t maxFrameLength = MAVLINK_MAX_PACKET_LEN;
+
+    /// Any thread. Copies data into the next free slot.
+    ///     @return false: queue closed or full, or data longer than maxFrameLength, nothing was queued
+    bool push(const char *data, size_t length);
+
+    /// Worker thread. Opened while the port of the worker is connected, a closed queue refuses every push
+    /// so writes to a disconnected link take the _writeBytes() path and report the error there.
+    void setOpen(bool open) { _open.store(open, std::memory_order_release); }
+    bool isOpen() const { return _open.load(std::memory_order_acquire); }
+
+    /// Worker thread. Calls callback(const char *data, size_t length) for every queued frame in order.
+    ///     @return Number of frames drained
+    template<typename Callback>
+    int drain(Callback &&callback)
+    {
+        int count = 0;
+        for (const Slot_t *slot = _queue.front(); slot; slot = _queue.front()) {
+            callback(slot->data, static_cast<size_t>(slot->length));
+            _queue.popFront();
+            count++;
+        }
+        return count;
+    }
+
+    /// Commands, mode changes and manual control, which must go out ahead of anything batched or paced.
+    /// Anything that is not a MAVLink frame counts as urgent too.
+    static bool isUrgentFrame(const char *data, size_t length);
+
+    size_t depth() const { return _queue.size(); }
+    size_t capacity() const { return _queue.capacity(); }
+    /// Frames dropped because the queue was full
+    uint64_t overflowCount() const { return _queue.overflowCount(); }
+    /// Worker thread. Frames dropped since the last call, for reporting
+    uint64_t takeOverflows();
+    uint64_t wakeupCount() const;
+
+signals:
+    /// Emitted on the worker thread when frames are waiting, drain() them all
+    void readyWrite();
+
+private:
+    struct Slot_t {
+        uint16_t length = 0;
+        char data[maxFrameLength];
+    };
+
+    MPSCQueue<Slot_t> _queue;
+    WakeupNotifier *_notifier = nullptr;
+    std::atomic<bool> _open{false};
+    uint64_t _reportedOverflows = 0;
+};
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/// Bounded lock-free queue for any number of producer threads and exactly one consumer thread.
+/// Every slot carries a sequence number telling producers and the consumer whose turn it is, so slots
+/// are claimed with a single compare-and-swap and filled in place. Slots are preallocated at construction,
+/// push and pop never allocate or block. A push into a full queue fails and is counted in overflowCount().
+template<typename T>
+class MPSCQueue
+{
+public:
+    /// @param capacity Rounded up to a power of two
+    explicit MPSCQueue(size_t capacity)
+        : _capacity(_roundUp(capacity))
+        , _mask(_capacity - 1)
+        , _cells(new Cell_t[_capacity])
+    {
+        for (size_t i = 0; i < _capacity; i++) {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue &operator=(const MPSCQueue&) = delete;
+
+    /// Any thread
+    bool push(const T &value)
+    {
+        return emplace([&value](T &slot) {
+            slot = value;
+        });
+    }
+
+    /// Any thread. Claims a slot and calls fill(T &slot) to fill it in place before publishing it.
+    ///     @return false: queue full, fill is not called
+    template<typename Fill>
+    bool emplace(Fill &&fill)
+    {
+        size_t position = _tail.load(std::memory_order_relaxed);
+        Cell_t *cell;
+        for (;;) {
+            cell = &_cells[position & _mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                if (_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                (void) _overflowCount.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                position = _tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        fill(cell->value);
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Consumer only
+    bool pop(T &value)
+    {
+        T *const slot = front();
+        if (!slot) {
+            return false;
+        }
+        value = *slot;
+        popFront();
+        return true;
+    }
+
+    /// Consumer only. Oldest published entry, nullptr when empty. Stays valid until popFront().
+    T *front()
+    {
+        const size_t head = _head.load(std::memory_order_relaxed);
+        Cell_t &cell = _cells[head & _mask];
+        if (cell.sequence.load(std::memory_order_acquire) != (head + 1)) {
+            return nullptr;
+        }
+        return &cell.value;
+    }
+
+    void popFront()
+    {
+        const size_t head = _head.load(std::memory_order_relaxed);
+        _cells[head & _mask].sequence.store(head + _capacity, std::memory_order_release);
+        _head.store(head + 1, std::memory_order_release);
+    }
+
+    /// Approximate, counts slots that are claimed but not yet published
+    size_t size() const { return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire); }
+    bool isEmpty() const { return size() == 0; }
+    size_t capacity() const { return _capacity; }
+    uint64_t overflowCount() const { return _overflowCount.load(std::memory_order_relaxed); }
+
+private:
+    static size_t _roundUp(size_t capacity)
+    {
+        size_t rounded = 1;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        return rounded;
+    }
+
+    static constexpr size_t _cacheLine = 64;
+
+    struct Cell_t {
+        std::atomic<size_t> sequence{0};
+        T value;
+    };
+
+    const size_t _capacity;
+    const size_t _mask;
+    const std::unique_ptr<Cell_t[]> _cells;
+
+    alignas(_cacheLine) std::atomic<size_t> _head{0};   ///< Written by the consumer
+    alignas(_cacheLine) std::atomic<size_t> _tail{0};   ///< Claimed by producers
+    std::atomic<uint64_t> _overflowCount{0};
+};
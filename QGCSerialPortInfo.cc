@@ -10,20 +10,34 @@
 #include "QGCSerialPortInfo.h"
 
 #include "JsonHelper.h"
+#ifdef QGC_USB_BOARD_INFO_TABLE
+#include "USBBoardInfoTable.h"
+#endif
 
 #include <QtCore/QFile>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
-#include <QRegularExpression>
+#include <QtCore/QSet>
+#include <QtCore/QStandardPaths>
+
+#include <algorithm>
 
 Q_LOGGING_CATEGORY(QGCSerialPortInfoLog, "qgc.comms.qgcserialportinfo")
 
 bool QGCSerialPortInfo::_jsonLoaded = false;
 bool QGCSerialPortInfo::_jsonDataValid = false;
+bool QGCSerialPortInfo::_boardTable = false;
 QList<QGCSerialPortInfo::BoardInfo_t> QGCSerialPortInfo::_boardInfoList;
+QHash<quint32, int> QGCSerialPortInfo::_boardInfoIndex;
 QList<QGCSerialPortInfo::BoardRegExpFallback_t> QGCSerialPortInfo::_boardDescriptionFallbackList;
 QList<QGCSerialPortInfo::BoardRegExpFallback_t> QGCSerialPortInfo::_boardManufacturerFallbackList;
+QHash<QString, QGCSerialPortInfo::BoardMatch_t> QGCSerialPortInfo::_boardMatchCache;
+QMutex QGCSerialPortInfo::_cacheMutex;
+QList<QSerialPortInfo> QGCSerialPortInfo::_portCache;
+QElapsedTimer QGCSerialPortInfo::_portCacheAge;
+bool QGCSerialPortInfo::_portCacheValid = false;
+bool QGCSerialPortInfo::_portChangesNotified = false;
 
 QGCSerialPortInfo::QGCSerialPortInfo()
     : QSerialPortInfo()
@@ -50,9 +64,65 @@ bool QGCSerialPortInfo::_loadJsonData()
 
     _jsonLoaded = true;
 
+    // A json in the config location replaces the built in boards, to add boards newer than the build
+    const QString overrideFile = QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation) + QStringLiteral("/") + QString(_jsonOverrideFileName);
+    if (QFile::exists(overrideFile)) {
+        if (_loadJsonFile(overrideFile)) {
+            qCDebug(QGCSerialPortInfoLog) << "Board info loaded from" << overrideFile;
+            _jsonDataValid = true;
+            return true;
+        }
+        qCWarning(QGCSerialPortInfoLog) << "Ignoring" << overrideFile;
+        _boardInfoList.clear();
+        _boardInfoIndex.clear();
+        _boardDescriptionFallbackList.clear();
+        _boardManufacturerFallbackList.clear();
+    }
+
+#ifdef QGC_USB_BOARD_INFO_TABLE
+    _jsonDataValid = _loadBoardTable();
+#else
+    _jsonDataValid = _loadJsonFile(QStringLiteral(":/json/USBBoardInfo.json"));
+#endif
+
+    return _jsonDataValid;
+}
+
+#ifdef QGC_USB_BOARD_INFO_TABLE
+bool QGCSerialPortInfo::_loadBoardTable()
+{
+    // The table was checked when it was generated, only the patterns are left to compile
+    const auto loadFallbacks = [](const USBBoardInfoTable::Fallback_t *fallback, QList<BoardRegExpFallback_t> &list) {
+        for (; fallback->regExp; fallback++) {
+            const BoardRegExpFallback_t boardFallback = {
+                QRegularExpression(QString::fromUtf8(fallback->regExp), QRegularExpression::CaseInsensitiveOption),
+                fallback->boardType,
+                fallback->androidOnly
+            };
+            if (!boardFallback.regExp.isValid()) {
+                qCWarning(QGCSerialPortInfoLog) << "Bad regExp" << boardFallback.regExp.pattern() << boardFallback.regExp.errorString();
+                return false;
+            }
+            list.append(boardFallback);
+        }
+        return true;
+    };
+
+    if (!loadFallbacks(USBBoardInfoTable::descriptionFallbacks, _boardDescriptionFallbackList) ||
+        !loadFallbacks(USBBoardInfoTable::manufacturerFallbacks, _boardManufacturerFallbackList)) {
+        return false;
+    }
+
+    _boardTable = true;
+    return true;
+}
+#endif
+
+bool QGCSerialPortInfo::_loadJsonFile(const QString &fileName)
+{
     QString errorString;
     int version;
-    const QJsonObject json = JsonHelper::openInternalQGCJsonFile(QStringLiteral(":/json/USBBoardInfo.json"), QString(_jsonFileTypeValue), 1, 1, version, errorString);
+    const QJsonObject json = JsonHelper::openInternalQGCJsonFile(fileName, QString(_jsonFileTypeValue), 1, 1, version, errorString);
     if (!errorString.isEmpty()) {
         qCWarning(QGCSerialPortInfoLog) << "Internal Error:" << errorString;
         return false;
@@ -99,6 +169,11 @@ bool QGCSerialPortInfo::_loadJsonData()
         }
 
         _boardInfoList.append(boardInfo);
+
+        const quint32 key = (static_cast<quint32>(boardInfo.vendorId) << 16) | static_cast<quint16>(boardInfo.productId);
+        if (!_boardInfoIndex.contains(key)) {
+            _boardInfoIndex.insert(key, _boardInfoList.count() - 1);
+        }
     }
 
     static const QList<JsonHelper::KeyValidateInfo> fallbackKeyInfoList = {
@@ -120,7 +195,7 @@ bool QGCSerialPortInfo::_loadJsonData()
         }
 
         const BoardRegExpFallback_t boardFallback = {
-            fallbackObject[_jsonRegExpKey].toString(),
+            QRegularExpression(fallbackObject[_jsonRegExpKey].toString(), QRegularExpression::CaseInsensitiveOption),
             _boardClassStringToType(fallbackObject[_jsonBoardClassKey].toString()),
             fallbackObject[_jsonAndroidOnlyKey].toBool(false)
         };
@@ -128,6 +203,10 @@ bool QGCSerialPortInfo::_loadJsonData()
             qCWarning(QGCSerialPortInfoLog) << "Bad board class" << fallbackObject[_jsonBoardClassKey].toString();
             return false;
         }
+        if (!boardFallback.regExp.isValid()) {
+            qCWarning(QGCSerialPortInfoLog) << "Bad regExp" << boardFallback.regExp.pattern() << boardFallback.regExp.errorString();
+            return false;
+        }
 
         _boardDescriptionFallbackList.append(boardFallback);
     }
@@ -146,7 +225,7 @@ bool QGCSerialPortInfo::_loadJsonData()
         }
 
         const BoardRegExpFallback_t boardFallback = {
-            fallbackObject[_jsonRegExpKey].toString(),
+            QRegularExpression(fallbackObject[_jsonRegExpKey].toString(), QRegularExpression::CaseInsensitiveOption),
             _boardClassStringToType(fallbackObject[_jsonBoardClassKey].toString()),
             fallbackObject[_jsonAndroidOnlyKey].toBool(false)
         };
@@ -154,12 +233,14 @@ bool QGCSerialPortInfo::_loadJsonData()
             qCWarning(QGCSerialPortInfoLog) << "Bad board class" << fallbackObject[_jsonBoardClassKey].toString();
             return false;
         }
+        if (!boardFallback.regExp.isValid()) {
+            qCWarning(QGCSerialPortInfoLog) << "Bad regExp" << boardFallback.regExp.pattern() << boardFallback.regExp.errorString();
+            return false;
+        }
 
         _boardManufacturerFallbackList.append(boardFallback);
     }
 
-    _jsonDataValid = true;
-
     return true;
 }
 
@@ -185,6 +266,8 @@ bool QGCSerialPortInfo::getBoardInfo(QGCSerialPortInfo::BoardType_t &boardType,
 {
     boardType = BoardTypeUnknown;
 
+    const QMutexLocker locker(&_cacheMutex);
+
     if (!_loadJsonData()) {
         return false;
     }
@@ -193,8 +276,59 @@ bool QGCSerialPortInfo::getBoardInfo(QGCSerialPortInfo::BoardType_t &boardType,
         return false;
     }
 
-    for (const BoardInfo_t &boardInfo : _boardInfoList) {
-        if ((vendorIdentifier() == boardInfo.vendorId) && ((productIdentifier() == boardInfo.productId) || (boardInfo.productId == 0))) {
+    const QString location = systemLocation();
+    auto match = _boardMatchCache.constFind(location);
+    if ((match == _boardMatchCache.constEnd()) || (match->vendorId != vendorIdentifier()) || (match->productId != productIdentifier()) || (match->serialNumber != serialNumber())) {
+        BoardMatch_t newMatch;
+        newMatch.vendorId = vendorIdentifier();
+        newMatch.productId = productIdentifier();
+        newMatch.serialNumber = serialNumber();
+        newMatch.boardType = BoardTypeUnknown;
+        newMatch.found = _matchBoard(newMatch.boardType, newMatch.name);
+        match = _boardMatchCache.insert(location, newMatch);
+    }
+
+    boardType = match->boardType;
+    if (match->found) {
+        name = match->name;
+    }
+    return match->found;
+}
+
+bool QGCSerialPortInfo::_matchBoard(BoardType_t &boardType, QString &name) const
+{
+    // Same result as a walk of the json board list: the earlier of the exact and the any product entry wins
+    const quint32 vendorKey = static_cast<quint32>(vendorIdentifier()) << 16;
+#ifdef QGC_USB_BOARD_INFO_TABLE
+    if (_boardTable) {
+        const auto find = [](quint32 key) -> const USBBoardInfoTable::Board_t* {
+            const USBBoardInfoTable::Board_t *const end = USBBoardInfoTable::boards + USBBoardInfoTable::boardCount;
+            const USBBoardInfoTable::Board_t *const board = std::lower_bound(USBBoardInfoTable::boards, end, key, [](const USBBoardInfoTable::Board_t &entry, quint32 value) {
+                return entry.key < value;
+            });
+            return ((board != end) && (board->key == key)) ? board : nullptr;
+        };
+
+        const USBBoardInfoTable::Board_t *board = find(vendorKey | productIdentifier());
+        const USBBoardInfoTable::Board_t *const anyProduct = find(vendorKey);
+        if (anyProduct && (!board || (anyProduct->order < board->order))) {
+            board = anyProduct;
+        }
+        if (board) {
+            boardType = board->boardType;
+            name = QString::fromUtf8(board->name);
+            return true;
+        }
+    } else
+#endif
+    {
+        int index = _boardInfoIndex.value(vendorKey | productIdentifier(), -1);
+        const int anyProductIndex = _boardInfoIndex.value(vendorKey, -1);
+        if ((anyProductIndex >= 0) && ((index < 0) || (anyProductIndex < index))) {
+            index = anyProductIndex;
+        }
+        if (index >= 0) {
+            const BoardInfo_t &boardInfo = _boardInfoList.at(index);
             boardType = boardInfo.boardType;
             name = boardInfo.name;
             return true;
@@ -204,7 +338,7 @@ bool QGCSerialPortInfo::getBoardInfo(QGCSerialPortInfo::BoardType_t &boardType,
     Q_ASSERT(boardType == BoardTypeUnknown);
 
     for (const BoardRegExpFallback_t &boardFallback : _boardDescriptionFallbackList) {
-        if (description().contains(QRegularExpression(boardFallback.regExp, QRegularExpression::CaseInsensitiveOption))) {
+        if (description().contains(boardFallback.regExp)) {
 #ifndef Q_OS_ANDROID
             if (boardFallback.androidOnly) {
                 continue;
@@ -217,7 +351,7 @@ bool QGCSerialPortInfo::getBoardInfo(QGCSerialPortInfo::BoardType_t &boardType,
     }
 
     for (const BoardRegExpFallback_t &boardFallback : _boardManufacturerFallbackList) {
-        if (manufacturer().contains(QRegularExpression(boardFallback.regExp, QRegularExpression::CaseInsensitiveOption))) {
+        if (manufacturer().contains(boardFallback.regExp)) {
 #ifndef Q_OS_ANDROID
             if (boardFallback.androidOnly) {
                 continue;
@@ -249,11 +383,58 @@ QString QGCSerialPortInfo::_boardTypeToString(BoardType_t boardType)
     }
 }
 
+QList<QSerialPortInfo> QGCSerialPortInfo::_ports()
+{
+    const QMutexLocker locker(&_cacheMutex);
+
+    if (!_portCacheValid || (!_portChangesNotified && _portCacheAge.hasExpired(_portListMaxAgeMSecs))) {
+        _portCache = QSerialPortInfo::availablePorts();
+        _portCacheAge.start();
+        _portCacheValid = true;
+
+        // Forget the boards of ports which are gone
+        QSet<QString> locations;
+        for (const QSerialPortInfo &portInfo : _portCache) {
+            locations.insert(portInfo.systemLocation());
+        }
+        for (auto it = _boardMatchCache.begin(); it != _boardMatchCache.end();) {
+            it = locations.contains(it.key()) ? (it + 1) : _boardMatchCache.erase(it);
+        }
+    }
+
+    return _portCache;
+}
+
+void QGCSerialPortInfo::invalidatePorts()
+{
+    const QMutexLocker locker(&_cacheMutex);
+    _portCacheValid = false;
+    _boardMatchCache.clear();
+}
+
+void QGCSerialPortInfo::setPortChangesNotified(bool notified)
+{
+    const QMutexLocker locker(&_cacheMutex);
+    _portChangesNotified = notified;
+}
+
+QGCSerialPortInfo QGCSerialPortInfo::fromPortName(const QString &name)
+{
+    const QList<QSerialPortInfo> ports = _ports();
+    for (const QSerialPortInfo &portInfo : ports) {
+        if ((portInfo.portName() == name) || (portInfo.systemLocation() == name)) {
+            return *reinterpret_cast<const QGCSerialPortInfo*>(&portInfo);
+        }
+    }
+
+    return QGCSerialPortInfo();
+}
+
 QList<QGCSerialPortInfo> QGCSerialPortInfo::availablePorts()
 {
     QList<QGCSerialPortInfo> list;
 
-    const QList<QSerialPortInfo> availablePorts = QSerialPortInfo::availablePorts();
+    const QList<QSerialPortInfo> availablePorts = _ports();
     for (const QSerialPortInfo &portInfo : availablePorts) {
         if (isSystemPort(portInfo)) {
             continue;
@@ -10,7 +10,11 @@
 
 #pragma once
 
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QMutex>
+#include <QtCore/QRegularExpression>
 #include <QtGlobal>
 #ifdef Q_OS_ANDROID
     #include "qserialportinfo.h"
@@ -24,6 +28,8 @@ Q_DECLARE_LOGGING_CATEGORY(QGCSerialPortInfoLog)
 
 /// QGC's version of Qt QSerialPortInfo. It provides additional information about board types
 /// that QGC cares about.
+/// Port enumeration is shared by every caller and thread, and board identification is memoised per
+/// port (system location, VID, PID, serial number) until the ports change. Both are thread safe.
 class QGCSerialPortInfo : public QSerialPortInfo
 {
     friend class QGCSerialPortInfoTest;
@@ -55,21 +61,46 @@ public:
     ///     @return true: Port is a system port and not an autopilot
     static bool isSystemPort(const QSerialPortInfo &port);
 
-    /// Override of QSerialPortInfo::availablePorts
+    /// Override of QSerialPortInfo::availablePorts, from the shared enumeration. That is redone after
+    /// invalidatePorts() and, unless port changes are notified, once it is older than _portListMaxAgeMSecs.
     static QList<QGCSerialPortInfo> availablePorts();
 
+    /// Same as QSerialPortInfo(const QString &name), from the shared enumeration
+    ///     @param name Port name or system location
+    ///     @return Null info if there is no such port
+    static QGCSerialPortInfo fromPortName(const QString &name);
+
+    /// Drops the shared enumeration and the memoised board identification, call when a port comes or goes
+    static void invalidatePorts();
+
+    /// @param notified true: invalidatePorts() is called on every change (SerialHotplugMonitor), the
+    ///                 enumeration never expires on its own
+    static void setPortChangesNotified(bool notified);
+
 private:
     struct BoardClassString2BoardType_t {
         const QString classString;
         const BoardType_t boardType = BoardTypeUnknown;
     };
 
+    /// Shared enumeration, system ports included
+    static QList<QSerialPortInfo> _ports();
+    /// Uncached lookup, _cacheMutex must be held
+    bool _matchBoard(BoardType_t &boardType, QString &name) const;
+
+    /// Built in boards, overridden by _jsonOverrideFileName in the config location
     static bool _loadJsonData();
+    static bool _loadJsonFile(const QString &fileName);
+#ifdef QGC_USB_BOARD_INFO_TABLE
+    /// Boards from the table generated out of USBBoardInfo.json at build time
+    static bool _loadBoardTable();
+#endif
     static BoardType_t _boardClassStringToType(const QString &boardClass);
     static QString _boardTypeToString(BoardType_t boardType);
 
     static bool _jsonLoaded;
     static bool _jsonDataValid;
+    static bool _boardTable;                        ///< true: boards are looked up in USBBoardInfoTable, not _boardInfoList
 
     struct BoardInfo_t {
         int vendorId;
@@ -78,16 +109,36 @@ private:
         QString name;
     };
     static QList<BoardInfo_t> _boardInfoList;
+    static QHash<quint32, int> _boardInfoIndex;     ///< key: vendorId << 16 | productId (0: any product), value: first entry in _boardInfoList
 
     struct BoardRegExpFallback_t {
-        QString regExp;
+        QRegularExpression regExp;                  ///< Compiled once when the json is loaded
         BoardType_t boardType;
         bool androidOnly;
     };
     static QList<BoardRegExpFallback_t> _boardDescriptionFallbackList;
     static QList<BoardRegExpFallback_t> _boardManufacturerFallbackList;
 
+    struct BoardMatch_t {
+        quint16 vendorId;
+        quint16 productId;
+        QString serialNumber;
+        bool found;
+        BoardType_t boardType;
+        QString name;
+    };
+    static QHash<QString, BoardMatch_t> _boardMatchCache;   ///< key: systemLocation
+
+    static QMutex _cacheMutex;                      ///< Guards the json data, _boardMatchCache and the port cache
+    static QList<QSerialPortInfo> _portCache;
+    static QElapsedTimer _portCacheAge;
+    static bool _portCacheValid;
+    static bool _portChangesNotified;
+
+    static constexpr int _portListMaxAgeMSecs = 500; ///< Shares one enumeration between the users of an autoconnect pass
+
     static constexpr const char *_jsonFileTypeValue = "USBBoardInfo";
+    static constexpr const char *_jsonOverrideFileName = "USBBoardInfo.json";
     static constexpr const char *_jsonBoardInfoKey = "boardInfo";
     static constexpr const char *_jsonBoardDescriptionFallbackKey = "boardDescriptionFallback";
     static constexpr const char *_jsonBoardManufacturerFallbackKey = "boardManufacturerFallback";
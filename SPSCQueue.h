@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+/// Slots are preallocated at construction, push and pop never allocate or block. A push into a full
+/// queue fails and is counted in overflowCount().
+template<typename T>
+class SPSCQueue
+{
+public:
+    /// @param capacity Rounded up to a power of two
+    explicit SPSCQueue(size_t capacity)
+        : _capacity(_roundUp(capacity))
+        , _mask(_capacity - 1)
+        , _slots(new T[_capacity])
+    {
+    }
+
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue &operator=(const SPSCQueue&) = delete;
+
+    /// Producer only
+    bool push(const T &value)
+    {
+        T *const slot = beginPush();
+        if (!slot) {
+            return false;
+        }
+        *slot = value;
+        endPush();
+        return true;
+    }
+
+    /// Producer only. Returns the next free slot to be filled in place, nullptr when full.
+    /// The slot is published by endPush().
+    T *beginPush()
+    {
+        const size_t tail = _tail.load(std::memory_order_relaxed);
+        if ((tail - _cachedHead) == _capacity) {
+            _cachedHead = _head.load(std::memory_order_acquire);
+            if ((tail - _cachedHead) == _capacity) {
+                (void) _overflowCount.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+        }
+        return &_slots[tail & _mask];
+    }
+
+    void endPush()
+    {
+        _tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /// Consumer only
+    bool pop(T &value)
+    {
+        T *const slot = front();
+        if (!slot) {
+            return false;
+        }
+        value = *slot;
+        popFront();
+        return true;
+    }
+
+    /// Consumer only. Oldest entry, nullptr when empty. Stays valid until popFront().
+    T *front()
+    {
+        const size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _cachedTail) {
+            _cachedTail = _tail.load(std::memory_order_acquire);
+            if (head == _cachedTail) {
+                return nullptr;
+            }
+        }
+        return &_slots[head & _mask];
+    }
+
+    void popFront()
+    {
+        _head.store(_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /// Consumer only. Number of entries at() can reach right now.
+    size_t readable()
+    {
+        _cachedTail = _tail.load(std::memory_order_acquire);
+        return _cachedTail - _head.load(std::memory_order_relaxed);
+    }
+
+    /// Consumer only. index-th oldest entry, index < readable(). Stays valid until popped.
+    T *at(size_t index) { return &_slots[(_head.load(std::memory_order_relaxed) + index) & _mask]; }
+
+    /// Consumer only. Pops the count oldest entries at once, count <= readable()
+    void popFront(size_t count)
+    {
+        _head.store(_head.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+    /// Approximate when called while the other side is active
+    size_t size() const { return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire); }
+    bool isEmpty() const { return size() == 0; }
+    size_t capacity() const { return _capacity; }
+    uint64_t overflowCount() const { return _overflowCount.load(std::memory_order_relaxed); }
+
+private:
+    static size_t _roundUp(size_t capacity)
+    {
+        size_t rounded = 1;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        return rounded;
+    }
+
+    static constexpr size_t _cacheLine = 64;
+
+    const size_t _capacity;
+    const size_t _mask;
+    const std::unique_ptr<T[]> _slots;
+
+    alignas(_cacheLine) std::atomic<size_t> _head{0};   ///< Written by the consumer
+    size_t _cachedTail = 0;                             ///< Consumer's copy of _tail
+
+    alignas(_cacheLine) std::atomic<size_t> _tail{0};   ///< Written by the producer
+    size_t _cachedHead = 0;                             ///< Producer's copy of _head
+    std::atomic<uint64_t> _overflowCount{0};
+};
@@ -0,0 +1,123 @@
+#include "SerialAutoConnectProbe.h"
+#include "MAVLinkFrameView.h"
+
+#ifdef Q_OS_ANDROID
+#include "qserialport.h"
+#else
+#include <QtSerialPort/QSerialPort>
+#endif
+#include <QtCore/QTimer>
+
+Q_LOGGING_CATEGORY(SerialAutoConnectProbeLog, "qgc.comms.serialautoconnectprobe")
+
+namespace {
+    /// GCS HEARTBEAT on a fresh sequence, so the bytes are always the same and never contain 0x20
+    QByteArray gcsHeartbeat()
+    {
+        mavlink_status_t status{};
+        mavlink_message_t message{};
+        (void) mavlink_msg_heartbeat_pack_status(
+            255,
+            MAV_COMP_ID_MISSIONPLANNER,
+            &status,
+            &message,
+            MAV_TYPE_GCS,
+            MAV_AUTOPILOT_INVALID,
+            0,
+            0,
+            MAV_STATE_ACTIVE
+            );
+
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        const uint16_t len = mavlink_msg_to_send_buffer(buffer, &message);
+        return QByteArray(reinterpret_cast<const char*>(buffer), len);
+    }
+}
+
+SerialAutoConnectProbe::SerialAutoConnectProbe(const QString &systemLocation, qint32 baud, int timeoutMSecs, QObject *parent)
+    : QObject(parent)
+    , _systemLocation(systemLocation)
+    , _baud(baud)
+    , _timeoutMSecs(timeoutMSecs)
+    , _port(new QSerialPort(this))
+    , _timer(new QTimer(this))
+{
+    _timer->setSingleShot(true);
+    (void) connect(_timer, &QTimer::timeout, this, &SerialAutoConnectProbe::_onTimeout);
+    (void) connect(_port, &QSerialPort::readyRead, this, &SerialAutoConnectProbe::_onReadyRead);
+    (void) connect(_port, &QSerialPort::errorOccurred, this, [this](QSerialPort::SerialPortError error) {
+        if ((error == QSerialPort::ResourceError) && (_result == Probing)) {
+            qCDebug(SerialAutoConnectProbeLog) << "Port went away" << _systemLocation;
+            _finish(Failed);
+        }
+    });
+}
+
+SerialAutoConnectProbe::~SerialAutoConnectProbe()
+{
+    _port->close();
+}
+
+bool SerialAutoConnectProbe::start()
+{
+    _clock.start();
+
+    _port->setPortName(_systemLocation);
+    if (!_port->open(QIODevice::ReadWrite)) {
+        qCDebug(SerialAutoConnectProbeLog) << "Open failed" << _systemLocation << _port->errorString();
+        _result = Failed;
+        return false;
+    }
+
+    // Same line setup as SerialWorker, USB CDC firmware only streams once DTR is up
+    (void) _port->setDataTerminalReady(true);
+    (void) _port->setBaudRate(_baud);
+
+    // Wakes firmware which waits for the GCS to talk first
+    if (_port->write(gcsHeartbeat()) < 0) {
+        qCDebug(SerialAutoConnectProbeLog) << "Heartbeat write failed" << _systemLocation << _port->errorString();
+    }
+
+    _timer->start(_timeoutMSecs);
+    qCDebug(SerialAutoConnectProbeLog) << "Listening for heartbeat" << _systemLocation;
+    return true;
+}
+
+void SerialAutoConnectProbe::_onReadyRead()
+{
+    const QByteArray data = _port->readAll();
+    if (_result != Probing) {
+        return;
+    }
+
+    bool heartbeat = false;
+    (void) _parser.parse(reinterpret_cast<const uint8_t*>(data.constData()), static_cast<size_t>(data.size()), [&heartbeat](const uint8_t *frame, size_t frameLength) {
+        const MAVLinkFrameView view(QByteArray::fromRawData(reinterpret_cast<const char*>(frame), static_cast<int>(frameLength)));
+        if (view.msgid() == MAVLINK_MSG_ID_HEARTBEAT) {
+            heartbeat = true;
+        }
+    });
+
+    if (heartbeat) {
+        _heartbeatMSecs = _clock.elapsed();
+        qCDebug(SerialAutoConnectProbeLog) << "Heartbeat on" << _systemLocation << "after" << _heartbeatMSecs << "ms";
+        _finish(Heartbeat);
+    }
+}
+
+void SerialAutoConnectProbe::_onTimeout()
+{
+    if (_result == Probing) {
+        qCDebug(SerialAutoConnectProbeLog) << "No heartbeat on" << _systemLocation << "within" << _timeoutMSecs << "ms";
+        _finish(Silent);
+    }
+}
+
+void SerialAutoConnectProbe::_finish(Result_t result)
+{
+    _result = result;
+    _timer->stop();
+    // Closed right away so the link can open the port
+    _port->close();
+    emit finished();
+}
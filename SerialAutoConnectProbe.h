@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+#include "MAVLinkFrameParser.h"
+
+class QSerialPort;
+class QTimer;
+
+Q_DECLARE_LOGGING_CATEGORY(SerialAutoConnectProbeLog)
+
+/// Opens a freshly seen autoconnect port and watches it for a valid MAVLink HEARTBEAT,
+/// so LinkManager can promote it to a link the moment the firmware talks instead of after a fixed boot wait.
+/// The only thing written is one GCS HEARTBEAT right after opening: PX4 starts MAVLink on USB only once the
+/// host sent something (cdcacm_autostart), so a silent probe would always time out on it. Bootloader ports
+/// are never probed, and should one slip through, the frame holds no 0x20 byte, the EOC every bootloader
+/// command such as GET_SYNC needs before it cancels the boot timeout. Without a heartbeat the probe ends as
+/// Silent once timeoutMSecs passed.
+/// Lives in the main thread.
+class SerialAutoConnectProbe : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Result_t {
+        Probing,
+        Heartbeat,          ///< Valid HEARTBEAT received, promote now
+        Silent,             ///< No heartbeat within the timeout, bootloader or a firmware that waits for the GCS
+        Failed              ///< Port could not be opened or went away
+    };
+
+    SerialAutoConnectProbe(const QString &systemLocation, qint32 baud, int timeoutMSecs, QObject *parent = nullptr);
+    ~SerialAutoConnectProbe();
+
+    /// @return false: the port could not be opened, result() is Failed
+    bool start();
+
+    Result_t result() const { return _result; }
+    const QString &systemLocation() const { return _systemLocation; }
+    /// ms from start() to the first heartbeat, -1 without one
+    qint64 heartbeatMSecs() const { return _heartbeatMSecs; }
+    /// ms since start()
+    qint64 elapsed() const { return _clock.elapsed(); }
+
+signals:
+    /// result() left Probing, the port is closed again
+    void finished();
+
+private slots:
+    void _onReadyRead();
+    void _onTimeout();
+
+private:
+    void _finish(Result_t result);
+
+    const QString _systemLocation;
+    const qint32 _baud;
+    const int _timeoutMSecs;
+    QSerialPort *_port = nullptr;
+    QTimer *_timer = nullptr;
+    MAVLinkFrameParser _parser;
+    QElapsedTimer _clock;
+    Result_t _result = Probing;
+    qint64 _heartbeatMSecs = -1;
+};
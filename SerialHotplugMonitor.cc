@@ -0,0 +1,203 @@
+#include "SerialHotplugMonitor.h"
+
+#include <QtCore/QSocketNotifier>
+
+#ifdef Q_OS_LINUX
+#include <arpa/inet.h>
+#include <linux/netlink.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    #include <QtCore/qapplicationstatic.h>
+    Q_APPLICATION_STATIC(SerialHotplugMonitor, _serialHotplugMonitorInstance);
+#else
+    #include <QtCore/QGlobalStatic>
+    Q_GLOBAL_STATIC(SerialHotplugMonitor, _serialHotplugMonitorInstance)
+#endif
+
+Q_LOGGING_CATEGORY(SerialHotplugMonitorLog, "qgc.comms.serialhotplugmonitor")
+
+SerialHotplugMonitor *SerialHotplugMonitor::instance()
+{
+    return _serialHotplugMonitorInstance();
+}
+
+#ifdef Q_OS_LINUX
+
+namespace {
+    constexpr unsigned KERNEL_GROUP = 1;
+    constexpr unsigned UDEV_GROUP = 2;
+    constexpr unsigned UDEV_MAGIC = 0xfeedcafe;
+    constexpr size_t MESSAGE_SIZE = 8192;
+
+    /// Header libudev puts in front of the properties of the events udevd multicasts
+    struct UdevMonitorHeader_t {
+        char prefix[8];                     ///< "libudev"
+        unsigned magic;                     ///< UDEV_MAGIC, network byte order
+        unsigned headerSize;
+        unsigned propertiesOffset;
+        unsigned propertiesLength;
+        unsigned filterSubsystemHash;
+        unsigned filterDevtypeHash;
+        unsigned filterTagBloomHi;
+        unsigned filterTagBloomLo;
+    };
+}
+
+SerialHotplugMonitor::SerialHotplugMonitor(QObject *parent)
+    : QObject(parent)
+{
+    _socket = socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+    if (_socket < 0) {
+        qCWarning(SerialHotplugMonitorLog) << "No uevent socket, serial ports are polled:" << strerror(errno);
+        return;
+    }
+
+    // Only udevd (root) is trusted to multicast udev events, its credentials come with every message
+    const int on = 1;
+    (void) setsockopt(_socket, SOL_SOCKET, SO_PASSCRED, &on, sizeof(on));
+
+    sockaddr_nl address{};
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = KERNEL_GROUP | UDEV_GROUP;
+    if (bind(_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        qCWarning(SerialHotplugMonitorLog) << "uevent socket bind failed, serial ports are polled:" << strerror(errno);
+        (void) ::close(_socket);
+        _socket = -1;
+        return;
+    }
+
+    _notifier = new QSocketNotifier(_socket, QSocketNotifier::Read, this);
+    (void) connect(_notifier, &QSocketNotifier::activated, this, &SerialHotplugMonitor::_onSocketActivated);
+
+    qCDebug(SerialHotplugMonitorLog) << "Listening for serial hotplug events";
+}
+
+SerialHotplugMonitor::~SerialHotplugMonitor()
+{
+    if (_socket >= 0) {
+        (void) ::close(_socket);
+    }
+}
+
+bool SerialHotplugMonitor::parseUevent(const char *data, size_t size, Event_t &event)
+{
+    const char *properties = data;
+    size_t propertiesSize = size;
+
+    event.fromUdev = (size >= sizeof(UdevMonitorHeader_t)) && (memcmp(data, "libudev", 8) == 0);
+    if (event.fromUdev) {
+        UdevMonitorHeader_t header;
+        (void) memcpy(&header, data, sizeof(header));
+        if ((ntohl(header.magic) != UDEV_MAGIC) || (header.propertiesOffset > size) || (header.propertiesLength > (size - header.propertiesOffset))) {
+            return false;
+        }
+        properties = data + header.propertiesOffset;
+        propertiesSize = header.propertiesLength;
+    } else {
+        // Kernel: "action@devpath" then the properties
+        const char *const end = static_cast<const char*>(memchr(data, '\0', size));
+        if (!end || !memchr(data, '@', static_cast<size_t>(end - data))) {
+            return false;
+        }
+    }
+
+    QString action;
+    QString subsystem;
+    QString devName;
+    for (size_t offset = 0; offset < propertiesSize;) {
+        const char *const property = properties + offset;
+        const size_t length = strnlen(property, propertiesSize - offset);
+        if (strncmp(property, "ACTION=", 7) == 0) {
+            action = QString::fromLatin1(property + 7, static_cast<int>(length - 7));
+        } else if (strncmp(property, "SUBSYSTEM=", 10) == 0) {
+            subsystem = QString::fromLatin1(property + 10, static_cast<int>(length - 10));
+        } else if (strncmp(property, "DEVNAME=", 8) == 0) {
+            devName = QString::fromLatin1(property + 8, static_cast<int>(length - 8));
+        }
+        offset += length + 1;
+    }
+
+    if ((subsystem != QStringLiteral("tty")) || devName.isEmpty()) {
+        return false;
+    }
+    if (action == QStringLiteral("add")) {
+        event.add = true;
+    } else if (action == QStringLiteral("remove")) {
+        event.add = false;
+    } else {
+        return false;
+    }
+
+    // The kernel names the node relative to /dev, udev gives the full path
+    event.systemLocation = devName.startsWith(QLatin1Char('/')) ? devName : (QStringLiteral("/dev/") + devName);
+    return true;
+}
+
+void SerialHotplugMonitor::_onSocketActivated()
+{
+    char buffer[MESSAGE_SIZE];
+    char control[CMSG_SPACE(sizeof(ucred))];
+
+    for (;;) {
+        sockaddr_nl sender{};
+        iovec iov{ buffer, sizeof(buffer) };
+        msghdr message{};
+        message.msg_name = &sender;
+        message.msg_namelen = sizeof(sender);
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        const ssize_t size = recvmsg(_socket, &message, 0);
+        if (size < 0) {
+            if (errno == ENOBUFS) {
+                qCWarning(SerialHotplugMonitorLog) << "uevents lost, rescanning";
+                emit rescanNeeded();
+                continue;
+            }
+            if (errno != EAGAIN) {
+                qCWarning(SerialHotplugMonitorLog) << "uevent receive failed:" << strerror(errno);
+            }
+            return;
+        }
+
+        const cmsghdr *const cmsg = CMSG_FIRSTHDR(&message);
+        if (!cmsg || (cmsg->cmsg_type != SCM_CREDENTIALS) || (reinterpret_cast<const ucred*>(CMSG_DATA(cmsg))->uid != 0)) {
+            continue;
+        }
+
+        Event_t event;
+        if (!parseUevent(buffer, static_cast<size_t>(size), event)) {
+            continue;
+        }
+        if (event.fromUdev) {
+            _udevSeen = true;
+        } else if ((sender.nl_pid != 0) || _udevSeen) {
+            // Kernel events only count without udev, its events follow once the node is usable
+            continue;
+        }
+
+        qCDebug(SerialHotplugMonitorLog) << (event.add ? "Added" : "Removed") << event.systemLocation << (event.fromUdev ? "(udev)" : "(kernel)");
+        if (event.add) {
+            emit serialPortAdded(event.systemLocation);
+        } else {
+            emit serialPortRemoved(event.systemLocation);
+        }
+    }
+}
+
+#else
+
+SerialHotplugMonitor::SerialHotplugMonitor(QObject *parent) : QObject(parent) {}
+SerialHotplugMonitor::~SerialHotplugMonitor() {}
+bool SerialHotplugMonitor::parseUevent(const char *, size_t, Event_t &) { return false; }
+void SerialHotplugMonitor::_onSocketActivated() {}
+
+#endif
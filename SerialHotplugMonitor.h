@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+#include <cstddef>
+
+class QSocketNotifier;
+
+Q_DECLARE_LOGGING_CATEGORY(SerialHotplugMonitorLog)
+
+/// Reports serial ports appearing and disappearing as it happens, from the uevents the kernel and udev
+/// multicast on a netlink socket, so neither LinkManager nor the serial workers have to enumerate every
+/// port once a second to notice. When udev runs its events are used, as they arrive after the device
+/// node got its permissions, otherwise the kernel's own.
+/// Linux only, isActive() is false elsewhere or when the socket can't be opened and callers keep polling.
+/// Lives in the main thread.
+class SerialHotplugMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SerialHotplugMonitor(QObject *parent = nullptr);
+    ~SerialHotplugMonitor();
+
+    static SerialHotplugMonitor *instance();
+
+    bool isActive() const { return (_socket >= 0); }
+
+    struct Event_t {
+        bool fromUdev = false;
+        bool add = false;                   ///< false: remove
+        QString systemLocation;             ///< /dev/ttyACM0
+    };
+
+    /// Decodes one kernel or libudev uevent message
+    ///     @return false for anything but a tty being added or removed
+    static bool parseUevent(const char *data, size_t size, Event_t &event);
+
+signals:
+    void serialPortAdded(const QString &systemLocation);
+    void serialPortRemoved(const QString &systemLocation);
+    /// Events were lost, a full scan is needed to catch up
+    void rescanNeeded();
+
+private slots:
+    void _onSocketActivated();
+
+private:
+    int _socket = -1;
+    bool _udevSeen = false;
+    QSocketNotifier *_notifier = nullptr;
+};
@@ -9,18 +9,44 @@
 
 #include "SerialLink.h"
 #include "QGCSerialPortInfo.h"
+#include "mavlinkprotocol.h"
+#include "LinkIOThreadPool.h"
+#include "MAVLinkFrameView.h"
+#include "MAVLinkMessageTable.h"
+#include "TermiosSerialPort.h"
+#include "SerialUringEngine.h"
+#include "SerialHotplugMonitor.h"
 
 
 #include <QSerialPortInfo>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
 #include <QtCore/QSettings>
-#include <QtCore/QThread>
+#include <QtCore/QSocketNotifier>
 #include <QtCore/QTimer>
 
+#include <cmath>
+
 Q_LOGGING_CATEGORY(SerialLinkLog, "SerialLinkLog")
 namespace {
     constexpr int CONNECT_TIMEOUT_MS = 1000;
     constexpr int DISCONNECT_TIMEOUT_MS = 3000;
     constexpr int READ_TIMEOUT_MS = 100;
+
+    /// Broadcasts sent in pieces, every copy carries different data
+    bool isFragmentedMessage(uint32_t msgid)
+    {
+        switch (msgid) {
+        case MAVLINK_MSG_ID_GPS_RTCM_DATA:
+        case MAVLINK_MSG_ID_STATUSTEXT:
+        case MAVLINK_MSG_ID_ENCAPSULATED_DATA:
+        case MAVLINK_MSG_ID_SERIAL_CONTROL:
+        case MAVLINK_MSG_ID_DATA_TRANSMISSION_HANDSHAKE:
+            return true;
+        default:
+            return false;
+        }
+    }
 }
 
 /*===========================================================================*/
@@ -74,6 +100,10 @@ void SerialConfiguration::copyFrom(const LinkConfiguration *source)
     setPortName(serialSource->portName());
     setPortDisplayName(serialSource->portDisplayName());
     setUsbDirect(serialSource->usbDirect());
+    setLowLatency(serialSource->lowLatency());
+    setUsbLatencyTimer(serialSource->usbLatencyTimer());
+    setTxQueueMs(serialSource->txQueueMs());
+    setTxOverflowPolicy(serialSource->txOverflowPolicy());
 }
 
 void SerialConfiguration::loadSettings(QSettings &settings, const QString &root)
@@ -87,6 +117,10 @@ void SerialConfiguration::loadSettings(QSettings &settings, const QString &root)
     setParity(static_cast<QSerialPort::Parity>(settings.value("parity", _parity).toInt()));
     setPortName(settings.value("portName", _portName).toString());
     setPortDisplayName(settings.value("portDisplayName", _portDisplayName).toString());
+    setLowLatency(settings.value("lowLatency", _lowLatency).toBool());
+    setUsbLatencyTimer(settings.value("usbLatencyTimer", _usbLatencyTimer).toInt());
+    setTxQueueMs(settings.value("txQueueMs", _txQueueMs).toInt());
+    setTxOverflowPolicy(static_cast<TxOverflowPolicy>(settings.value("txOverflowPolicy", _txOverflowPolicy).toInt()));
 
     settings.endGroup();
 }
@@ -102,6 +136,10 @@ void SerialConfiguration::saveSettings(QSettings &settings, const QString &root)
     settings.setValue("parity", _parity);
     settings.setValue("portName", _portName);
     settings.setValue("portDisplayName", _portDisplayName);
+    settings.setValue("lowLatency", _lowLatency);
+    settings.setValue("usbLatencyTimer", _usbLatencyTimer);
+    settings.setValue("txQueueMs", _txQueueMs);
+    settings.setValue("txOverflowPolicy", _txOverflowPolicy);
 
     settings.endGroup();
 }
@@ -183,14 +221,186 @@ QStringList SerialConfiguration::supportedBaudRates()
 
 QString SerialConfiguration::cleanPortDisplayName(const QString &name)
 {
-    const QList<QSerialPortInfo> availablePorts = QSerialPortInfo::availablePorts();
-    for (const QSerialPortInfo &portInfo : availablePorts) {
-        if (portInfo.systemLocation() == name) {
-            return portInfo.portName();
+    return QGCSerialPortInfo::fromPortName(name).portName();
+}
+
+/*===========================================================================*/
+
+SerialTxQueue::SerialTxQueue()
+{
+    _clock.start();
+}
+
+void SerialTxQueue::configure(qint64 bytesPerSecond, int maxQueueMs, SerialConfiguration::TxOverflowPolicy policy)
+{
+    _bytesPerSecond = bytesPerSecond;
+    _policy = policy;
+    if (bytesPerSecond > 0) {
+        _maxQueueBytes = qMax<qint64>(MAVLINK_MAX_PACKET_LEN, bytesPerSecond * maxQueueMs / 1000);
+        // A frame goes out as soon as the budget is positive, so the line never holds more than one frame plus the burst
+        _maxBudget = qMax<double>(1, bytesPerSecond * _burstMs / 1000.0);
+    } else {
+        _maxQueueBytes = 0;
+        _maxBudget = 1;
+    }
+    _budget = _maxBudget;
+    _lastRefillNs = _clock.nsecsElapsed();
+}
+
+bool SerialTxQueue::enqueueFrame(const char *data, qint64 length)
+{
+    Frame_t frame;
+    frame.bytes = QByteArray(data, static_cast<int>(length));
+
+    const bool urgent = MAVLinkTxQueue::isUrgentFrame(data, static_cast<size_t>(length));
+    if (!urgent) {
+        // Requests and transfers carry a target and must all arrive, broadcast state only needs the latest copy
+        const MAVLinkFrameView view(frame.bytes);
+        const uint32_t msgid = view.msgid();
+        const mavlink_msg_entry_t *const entry = MAVLinkMessageTable::entry(msgid);
+        frame.coalescable = entry && !(entry->flags & MAV_MSG_ENTRY_FLAG_HAVE_TARGET_SYSTEM) && !isFragmentedMessage(msgid);
+        frame.key = (static_cast<quint64>(msgid) << 16) | (static_cast<quint64>(view.sysid()) << 8) | view.compid();
+    }
+
+    return _enqueue(std::move(frame), urgent);
+}
+
+bool SerialTxQueue::enqueueRaw(const char *data, qint64 length)
+{
+    Frame_t frame;
+    frame.bytes = QByteArray(data, static_cast<int>(length));
+    return _enqueue(std::move(frame), false);
+}
+
+bool SerialTxQueue::_enqueue(Frame_t &&frame, bool urgent)
+{
+    const qint64 size = frame.bytes.size();
+
+    if (urgent) {
+        // Only bounded against a runaway producer, urgent traffic is small
+        if ((_maxQueueBytes > 0) && !_urgent.empty() && ((_urgentBytes + size) > _maxQueueBytes)) {
+            (void) _droppedFrames.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        _urgentBytes += size;
+        _urgent.push_back(std::move(frame));
+    } else {
+        if ((_maxQueueBytes > 0) && !_normal.empty() && ((_normalBytes + size) > _maxQueueBytes)) {
+            bool replaced = false;
+            const bool queue = _overflow(frame, replaced);
+            _updateDepth();
+            if (!queue) {
+                (void) _droppedFrames.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (replaced) {
+                return true;
+            }
+        }
+        _normalBytes += frame.bytes.size();
+        _normal.push_back(std::move(frame));
+    }
+
+    _updateDepth();
+    return true;
+}
+
+bool SerialTxQueue::_overflow(Frame_t &frame, bool &replaced)
+{
+    if (_policy == SerialConfiguration::TxDropNewest) {
+        return false;
+    }
+
+    if (frame.coalescable) {
+        for (Frame_t &queued : _normal) {
+            if (queued.coalescable && (queued.key == frame.key)) {
+                _normalBytes += frame.bytes.size() - queued.bytes.size();
+                queued.bytes = frame.bytes;
+                (void) _coalescedFrames.fetch_add(1, std::memory_order_relaxed);
+                replaced = true;
+                return true;
+            }
         }
     }
 
-    return QString();
+    // The oldest frame is the stalest
+    while (!_normal.empty() && ((_normalBytes + frame.bytes.size()) > _maxQueueBytes)) {
+        _normalBytes -= _normal.front().bytes.size();
+        _normal.pop_front();
+        (void) _droppedFrames.fetch_add(1, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+void SerialTxQueue::_pop(std::deque<Frame_t> &lane, bool written)
+{
+    qint64 &laneBytes = (&lane == &_urgent) ? _urgentBytes : _normalBytes;
+    laneBytes -= lane.front().bytes.size();
+    lane.pop_front();
+
+    (void) (written ? _sentFrames : _failedFrames).fetch_add(1, std::memory_order_relaxed);
+    _updateDepth();
+}
+
+void SerialTxQueue::_refill()
+{
+    if (_bytesPerSecond <= 0) {
+        return;
+    }
+
+    const qint64 now = _clock.nsecsElapsed();
+    _budget = qMin(_maxBudget, _budget + (static_cast<double>(now - _lastRefillNs) * _bytesPerSecond / 1e9));
+    _lastRefillNs = now;
+}
+
+int SerialTxQueue::_nextServiceMs() const
+{
+    if (isEmpty()) {
+        return -1;
+    }
+    if ((_bytesPerSecond <= 0) || (_budget > 0)) {
+        return 0;
+    }
+    // Until the line has sent what was written and has room for at least a byte again
+    return static_cast<int>(std::ceil((1 - _budget) * 1000.0 / _bytesPerSecond));
+}
+
+void SerialTxQueue::_updateDepth()
+{
+    const qint64 depthBytes = _urgentBytes + _normalBytes;
+    _depthFrames.store(static_cast<int>(_urgent.size() + _normal.size()), std::memory_order_relaxed);
+    _depthBytes.store(depthBytes, std::memory_order_relaxed);
+    if (depthBytes > _peakDepthBytes.load(std::memory_order_relaxed)) {
+        _peakDepthBytes.store(depthBytes, std::memory_order_relaxed);
+    }
+}
+
+void SerialTxQueue::clear()
+{
+    _urgent.clear();
+    _normal.clear();
+    _urgentBytes = 0;
+    _normalBytes = 0;
+    _updateDepth();
+}
+
+SerialTxQueue::Stats_t SerialTxQueue::stats() const
+{
+    Stats_t stats;
+    stats.depthFrames = _depthFrames.load(std::memory_order_relaxed);
+    stats.depthBytes = _depthBytes.load(std::memory_order_relaxed);
+    stats.peakDepthBytes = _peakDepthBytes.load(std::memory_order_relaxed);
+    stats.sentFrames = _sentFrames.load(std::memory_order_relaxed);
+    stats.droppedFrames = _droppedFrames.load(std::memory_order_relaxed);
+    stats.coalescedFrames = _coalescedFrames.load(std::memory_order_relaxed);
+    stats.failedFrames = _failedFrames.load(std::memory_order_relaxed);
+    return stats;
+}
+
+qint64 SerialTxQueue::lineRate(qint32 baud, int dataBits, bool parity, int stopBits)
+{
+    const int bitsPerByte = 1 + dataBits + (parity ? 1 : 0) + stopBits;
+    return baud / bitsPerByte;
 }
 
 /*===========================================================================*/
@@ -198,10 +408,14 @@ QString SerialConfiguration::cleanPortDisplayName(const QString &name)
 SerialWorker::SerialWorker(const SerialConfiguration *config, QObject *parent)
     : QObject(parent)
     , _serialConfig(config)
+    , _txQueue(new MAVLinkTxQueue(_txQueueSlots, this))
+    , _readBuffer(_readBufferSize)
 {
     // qCDebug(SerialLinkLog) << this;
 
     (void) qRegisterMetaType<QSerialPort::SerialPortError>("QSerialPort::SerialPortError");
+
+    (void) connect(_txQueue, &MAVLinkTxQueue::readyWrite, this, &SerialWorker::_onTxReady);
 }
 
 SerialWorker::~SerialWorker()
@@ -213,17 +427,14 @@ SerialWorker::~SerialWorker()
 
 bool SerialWorker::isConnected() const
 {
-    return (_port && _port->isOpen());
+    return (_nativePort && _nativePort->isOpen()) || (_port && _port->isOpen());
 }
 
-void SerialWorker::setupPort()
+void SerialWorker::setupPort(bool hotplugEvents)
 {
     Q_ASSERT(!_port);
     _port = new QSerialPort(this);
 
-    Q_ASSERT(!_timer);
-    _timer = new QTimer(this);
-
     (void) connect(_port, &QSerialPort::aboutToClose, this, &SerialWorker::_onPortDisconnected);
     (void) connect(_port, &QSerialPort::readyRead, this, &SerialWorker::_onPortReadyRead);
     (void) connect(_port, &QSerialPort::errorOccurred, this, &SerialWorker::_onPortErrorOccurred);
@@ -232,8 +443,17 @@ void SerialWorker::setupPort()
         (void) connect(_port, &QSerialPort::bytesWritten, this, &SerialWorker::_onPortBytesWritten);
     } */
 
-    (void) connect(_timer, &QTimer::timeout, this, &SerialWorker::_checkPortAvailability);
-    _timer->start(CONNECT_TIMEOUT_MS);
+    if (!hotplugEvents) {
+        Q_ASSERT(!_timer);
+        _timer = new QTimer(this);
+        (void) connect(_timer, &QTimer::timeout, this, &SerialWorker::_checkPortAvailability);
+        _timer->start(CONNECT_TIMEOUT_MS);
+    }
+
+    _txTimer = new QTimer(this);
+    _txTimer->setSingleShot(true);
+    _txTimer->setTimerType(Qt::PreciseTimer);
+    (void) connect(_txTimer, &QTimer::timeout, this, &SerialWorker::_serviceTxQueue);
 }
 
 void SerialWorker::connectToPort()
@@ -245,7 +465,7 @@ void SerialWorker::connectToPort()
 
     _port->setPortName(_serialConfig->portName());
 
-    const QGCSerialPortInfo portInfo(*_port); // 使用標準 Qt 類別
+    const QGCSerialPortInfo portInfo = QGCSerialPortInfo::fromPortName(_port->portName());
 
     // 檢查是否為常見的 Bootloader 模式 (範例 ID)
     uint16_t vid = portInfo.vendorIdentifier();
@@ -270,6 +490,15 @@ void SerialWorker::connectToPort()
 
     _errorEmitted = false;
 
+    if (_serialConfig->lowLatency() && TermiosSerialPort::isSupported()) {
+        if (_openNative()) {
+            _onPortConnected();
+            return;
+        }
+        qCWarning(SerialLinkLog) << "Low latency open of" << _port->portName() << "failed, using QSerialPort:" << _nativePort->errorString();
+        _nativePort.reset();
+    }
+
     qDebug() << "Attempting to open port" << _port->portName();
     if (!_port->open(QIODevice::ReadWrite)) {
         qCWarning(SerialLinkLog) << "Opening port" << _port->portName() << "failed:" << _port->errorString();
@@ -296,6 +525,11 @@ void SerialWorker::disconnectFromPort()
     }
 
     qCDebug(SerialLinkLog) << "Attempting to close port:" << _port->portName();
+    if (_nativePort) {
+        _closeNative();
+        _onPortDisconnected();
+        return;
+    }
     _port->close();
 }
 
@@ -311,36 +545,127 @@ void SerialWorker::writeData(const QByteArray &data)
         return;
     }
 
+    // Frames queued before this write go first
+    _onTxReady();
+
+    if (!_pacedQueue.enqueueRaw(data.constData(), data.size())) {
+        qCDebug(SerialLinkLog) << "Transmit queue full," << data.size() << "bytes dropped";
+        return;
+    }
+    _serviceTxQueue();
+}
+
+void SerialWorker::_onTxReady()
+{
+    if (!isConnected()) {
+        // Report once, the whole batch is discarded
+        if (_txQueue->drain([](const char*, size_t) {}) > 0) {
+            emit errorOccurred(tr("Port is not Connected"));
+        }
+        return;
+    }
+
+    (void) _txQueue->drain([this](const char *data, size_t length) {
+        if (!_pacedQueue.enqueueFrame(data, static_cast<qint64>(length))) {
+            qCDebug(SerialLinkLog) << "Transmit queue full, frame dropped";
+        }
+    });
+    if (const uint64_t dropped = _txQueue->takeOverflows()) {
+        qCWarning(SerialLinkLog) << "Outbound queue full," << dropped << "frames dropped";
+    }
+    _serviceTxQueue();
+}
+
+void SerialWorker::_serviceTxQueue()
+{
+    _txTimer->stop();
+
+    // Only what the port took is reported sent, not what was queued, dropped or coalesced away
+    const int nextMs = _pacedQueue.service([this](const QByteArray &bytes) {
+        if (_write(bytes.constData(), bytes.size()) < 0) {
+            return false;
+        }
+        _sentBytes.append(bytes);
+        return true;
+    });
+    // The whole round goes to the kernel in one submission
+    if (_uringEngine && !_uringEngine->submit()) {
+        emit errorOccurred(tr("Could Not Send Data - Write Failed: %1").arg(_uringEngine->errorString()));
+    }
+    if (!_sentBytes.isEmpty()) {
+        emit dataSent(_sentBytes);
+        _sentBytes.clear();
+    }
+    if (nextMs >= 0) {
+        _txTimer->start(nextMs);
+    }
+}
+
+qint64 SerialWorker::_write(const char *data, qint64 length)
+{
+    if (!isConnected()) {
+        emit errorOccurred(tr("Port is not Connected"));
+        return -1;
+    }
+
+    if (_uringEngine) {
+        // Started by _serviceTxQueue() once the round is done
+        _uringEngine->write(data, length);
+        return length;
+    }
+
+    if (_nativePort) {
+        // Whatever the tty does not take now goes out when it turns writable again
+        if (!_nativePort->write(data, length)) {
+            emit errorOccurred(tr("Could Not Send Data - Write Failed: %1").arg(_nativePort->errorString()));
+            return -1;
+        }
+        _nativeWriteNotifier->setEnabled(_nativePort->bytesToWrite() > 0);
+        return length;
+    }
+
     if (!_port->isWritable()) {
         emit errorOccurred(tr("Port is not Writable"));
-        return;
+        return -1;
     }
 
     qint64 totalBytesWritten = 0;
-    while (totalBytesWritten < data.size()) {
-        const qint64 bytesWritten = _port->write(data.constData() + totalBytesWritten, data.size() - totalBytesWritten);
+    while (totalBytesWritten < length) {
+        const qint64 bytesWritten = _port->write(data + totalBytesWritten, length - totalBytesWritten);
         if (bytesWritten == -1) {
             emit errorOccurred(tr("Could Not Send Data - Write Failed: %1").arg(_port->errorString()));
-            return;
+            return -1;
         } else if (bytesWritten == 0) {
             emit errorOccurred(tr("Could Not Send Data - Write Returned 0 Bytes"));
-            return;
+            return -1;
         }
         totalBytesWritten += bytesWritten;
     }
 
-    #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-        const QByteArray sent = data.first(totalBytesWritten);
-    #else
-        const QByteArray sent = data.left(totalBytesWritten);
-    #endif
-    emit dataSent(sent);
+    return totalBytesWritten;
 }
 
 void SerialWorker::_onPortConnected()
 {
     qCDebug(SerialLinkLog) << "Port connected:" << _port->portName();
 
+    // A USB direct port runs at bus speed whatever its baud rate says
+    qint64 bytesPerSecond = 0;
+    if (!_serialConfig->usbDirect() && (_serialConfig->txQueueMs() > 0)) {
+        const bool parity = (_serialConfig->parity() != QSerialPort::NoParity);
+        const int stopBits = (_serialConfig->stopBits() == QSerialPort::OneStop) ? 1 : 2;
+        bytesPerSecond = SerialTxQueue::lineRate(_serialConfig->baud(), _serialConfig->dataBits(), parity, stopBits);
+    }
+    _pacedQueue.configure(bytesPerSecond, _serialConfig->txQueueMs(), _serialConfig->txOverflowPolicy());
+    _txQueue->setOpen(true);
+
+    if (_nativePort) {
+        // Configured by _openNative()
+        _errorEmitted = false;
+        emit connected();
+        return;
+    }
+
     _port->setDataTerminalReady(true);
     _port->setBaudRate(_serialConfig->baud());
     _port->setDataBits(static_cast<QSerialPort::DataBits>(_serialConfig->dataBits()));
@@ -355,17 +680,153 @@ void SerialWorker::_onPortConnected()
 void SerialWorker::_onPortDisconnected()
 {
     qCDebug(SerialLinkLog) << "Port disconnected:" << _port->portName();
+
+    // Nothing queued for this connection is sent on the next one
+    _txQueue->setOpen(false);
+    _txTimer->stop();
+    _pacedQueue.clear();
+
     _errorEmitted = false;
     emit disconnected();
 }
 
 void SerialWorker::_onPortReadyRead()
 {
-    const QByteArray data = _port->readAll();
-    if (!data.isEmpty()) {
-        // qCDebug(SerialLinkLog) << data.size();
-        emit dataReceived(data);
+    if (!_framingChannel) {
+        const QByteArray data = _port->readAll();
+        if (!data.isEmpty()) {
+            // qCDebug(SerialLinkLog) << data.size();
+            emit dataReceived(data);
+        }
+        return;
+    }
+
+    qint64 bytesRead;
+    while ((bytesRead = _port->read(_readBuffer.data(), static_cast<qint64>(_readBuffer.size()))) > 0) {
+        _processReceived(_readBuffer.data(), bytesRead);
+    }
+}
+
+void SerialWorker::_processReceived(const char *data, qint64 size)
+{
+    if (!_framingChannel) {
+        emit dataReceived(QByteArray(data, static_cast<int>(size)));
+        return;
     }
+
+    (void) _framingChannel->parser.parse(reinterpret_cast<const uint8_t*>(data), static_cast<size_t>(size), [this](const uint8_t *frame, size_t frameLength) {
+        if (!_rxRing->push(frame, frameLength)) {
+            qCDebug(SerialLinkLog) << "Receive ring full, frame dropped";
+        }
+    });
+}
+
+bool SerialWorker::_openNative()
+{
+    // The configured name is usually the system location already, the port lookup also resolves bare names
+    QString systemLocation = QGCSerialPortInfo::fromPortName(_serialConfig->portName()).systemLocation();
+    if (systemLocation.isEmpty()) {
+        systemLocation = _serialConfig->portName();
+    }
+
+    _nativePort = std::make_unique<TermiosSerialPort>();
+    if (!_nativePort->open(systemLocation)) {
+        return false;
+    }
+    if (!_nativePort->configure(_serialConfig->baud(), _serialConfig->dataBits(), _serialConfig->parity(), _serialConfig->stopBits(), _serialConfig->flowControl())) {
+        _nativePort->close();
+        return false;
+    }
+    (void) _nativePort->setDataTerminalReady(true);
+
+    // Both are best effort, a CDC ACM Pixhawk has neither and does not need them
+    if (!_nativePort->setLowLatency(true)) {
+        qCDebug(SerialLinkLog) << systemLocation << "low latency flag not set:" << _nativePort->errorString();
+    }
+    if ((_serialConfig->usbLatencyTimer() > 0) && !_nativePort->setUsbLatencyTimer(_serialConfig->usbLatencyTimer())) {
+        qCDebug(SerialLinkLog) << systemLocation << "USB latency timer not set:" << _nativePort->errorString();
+    }
+
+    // Opt in, the socket notifiers below stay the fallback
+    if (SerialUringEngine::isSupported() && QSettings().value(_ioUringKey, false).toBool()) {
+        _uringEngine = std::make_unique<SerialUringEngine>();
+        if (_uringEngine->open(_nativePort->fd())) {
+            _uringNotifier = new QSocketNotifier(_uringEngine->eventFd(), QSocketNotifier::Read, this);
+            (void) connect(_uringNotifier, &QSocketNotifier::activated, this, &SerialWorker::_onUringReady);
+            qCDebug(SerialLinkLog) << "Opened" << systemLocation << "in low latency mode through io_uring";
+            return true;
+        }
+        qCDebug(SerialLinkLog) << "io_uring not available for" << systemLocation << _uringEngine->errorString();
+        _uringEngine.reset();
+    }
+
+    _nativeReadNotifier = new QSocketNotifier(_nativePort->fd(), QSocketNotifier::Read, this);
+    (void) connect(_nativeReadNotifier, &QSocketNotifier::activated, this, &SerialWorker::_onNativeReadyRead);
+    _nativeWriteNotifier = new QSocketNotifier(_nativePort->fd(), QSocketNotifier::Write, this);
+    _nativeWriteNotifier->setEnabled(false);
+    (void) connect(_nativeWriteNotifier, &QSocketNotifier::activated, this, &SerialWorker::_onNativeReadyWrite);
+
+    qCDebug(SerialLinkLog) << "Opened" << systemLocation << "in low latency mode";
+    return true;
+}
+
+void SerialWorker::_closeNative()
+{
+    // Notifiers and the ring go before the descriptor they watch
+    for (QSocketNotifier **notifier : { &_nativeReadNotifier, &_nativeWriteNotifier, &_uringNotifier }) {
+        if (*notifier) {
+            (*notifier)->setEnabled(false);
+            (*notifier)->deleteLater();
+            *notifier = nullptr;
+        }
+    }
+    _uringEngine.reset();
+    _nativePort.reset();
+}
+
+void SerialWorker::_onNativeReadyRead()
+{
+    const qint64 capacity = static_cast<qint64>(_readBuffer.size());
+    qint64 bytesRead;
+    do {
+        bytesRead = _nativePort->read(_readBuffer.data(), capacity);
+        if (bytesRead < 0) {
+            _onNativeError(_nativePort->errorString());
+            return;
+        }
+        if (bytesRead > 0) {
+            _processReceived(_readBuffer.data(), bytesRead);
+        }
+    } while (bytesRead == capacity);
+}
+
+void SerialWorker::_onUringReady()
+{
+    const int reads = _uringEngine->reap([this](const char *data, qint64 size) {
+        _processReceived(data, size);
+    });
+    if (reads < 0) {
+        _onNativeError(_uringEngine->errorString());
+    }
+}
+
+void SerialWorker::_onNativeError(const QString &errorString)
+{
+    qCWarning(SerialLinkLog) << "Port error:" << _port->portName() << errorString;
+    // Unplugged cables come back through autoconnect, same as a QSerialPort::ResourceError
+    if (!_errorEmitted && !_serialConfig->isAutoConnect()) {
+        emit errorOccurred(errorString);
+        _errorEmitted = true;
+    }
+    disconnectFromPort();
+}
+
+void SerialWorker::_onNativeReadyWrite()
+{
+    if (!_nativePort->flush()) {
+        emit errorOccurred(tr("Could Not Send Data - Write Failed: %1").arg(_nativePort->errorString()));
+    }
+    _nativeWriteNotifier->setEnabled(_nativePort->bytesToWrite() > 0);
 }
 
 void SerialWorker::_onPortBytesWritten(qint64 bytes) const
@@ -406,17 +867,27 @@ void SerialWorker::_checkPortAvailability()
         return;
     }
 
-    bool portExists = false;
-    const auto availablePorts = QSerialPortInfo::availablePorts();
-    for (const QSerialPortInfo &info : availablePorts) {
-        if (info.portName() == _serialConfig->portDisplayName()) {
-            portExists = true;
-            break;
-        }
+    if (QGCSerialPortInfo::fromPortName(_serialConfig->portName()).isNull()) {
+        disconnectFromPort();
+    }
+}
+
+void SerialWorker::portRemoved(const QString &systemLocation)
+{
+    if (!isConnected()) {
+        return;
+    }
+
+    const QString portName = _serialConfig->portName();
+    bool gone = (portName == systemLocation) || (portName == QFileInfo(systemLocation).fileName());
+    if (!gone && QFileInfo(portName).isAbsolute()) {
+        // Opened through an alias such as /dev/serial/by-id/..., which udev drops with the device
+        gone = !QFile::exists(portName);
     }
 
-    if (!portExists) {
-        _port->close();
+    if (gone) {
+        qCDebug(SerialLinkLog) << "Port removed" << systemLocation;
+        disconnectFromPort();
     }
 }
 
@@ -426,16 +897,10 @@ SerialLink::SerialLink(SharedLinkConfigurationPtr &config, QObject *parent)
     : LinkInterface(config, parent)
     , _serialConfig(qobject_cast<const SerialConfiguration*>(config.get()))
     , _worker(new SerialWorker(_serialConfig))
-    , _workerThread(new QThread(this))
 {
     // qCDebug(SerialLinkLog) << this;
 
-    _workerThread->setObjectName(QStringLiteral("Serial_%1").arg(_serialConfig->name()));
-
-    (void) _worker->moveToThread(_workerThread);
-
-    (void) connect(_workerThread, &QThread::started, _worker, &SerialWorker::setupPort);
-    (void) connect(_workerThread, &QThread::finished, _worker, &QObject::deleteLater);
+    _setTxQueue(_worker->txQueue());
 
     (void) connect(_worker, &SerialWorker::connected, this, &SerialLink::_onConnected, Qt::QueuedConnection);
     (void) connect(_worker, &SerialWorker::disconnected, this, &SerialLink::_onDisconnected, Qt::QueuedConnection);
@@ -443,17 +908,24 @@ SerialLink::SerialLink(SharedLinkConfigurationPtr &config, QObject *parent)
     (void) connect(_worker, &SerialWorker::dataSent, this, &SerialLink::_onDataSent, Qt::QueuedConnection);
     (void) connect(_worker, &SerialWorker::errorOccurred, this, &SerialLink::_onErrorOccurred, Qt::QueuedConnection);
 
-    _workerThread->start();
+    SerialHotplugMonitor *const hotplug = SerialHotplugMonitor::instance();
+    const bool hotplugEvents = hotplug->isActive();
+    if (hotplugEvents) {
+        (void) connect(hotplug, &SerialHotplugMonitor::serialPortRemoved, _worker, &SerialWorker::portRemoved, Qt::QueuedConnection);
+    }
+
+    SerialWorker *const worker = _worker;
+    LinkIOThreadPool::instance()->attach(_worker, QStringLiteral("Serial_%1").arg(_serialConfig->name()), [worker, hotplugEvents] {
+        worker->setupPort(hotplugEvents);
+    });
 }
 
 SerialLink::~SerialLink()
 {
     (void) QMetaObject::invokeMethod(_worker, "disconnectFromPort", Qt::BlockingQueuedConnection);
 
-    _workerThread->quit();
-    if (!_workerThread->wait(DISCONNECT_TIMEOUT_MS)) {
-        qCWarning(SerialLinkLog) << "Failed to wait for Serial Thread to close";
-    }
+    _setTxQueue(nullptr);
+    LinkIOThreadPool::instance()->detach(_worker, DISCONNECT_TIMEOUT_MS);
 
     // qCDebug(SerialLinkLog) << this;
 }
@@ -465,9 +937,31 @@ bool SerialLink::isConnected() const
 
 bool SerialLink::_connect()
 {
+    _workerFraming = MAVLinkProtocol::instance()->workerFraming();
+    if (_workerFraming) {
+        MAVLinkChannel *const channel = mavlinkChannel();
+        MAVLinkFrameRing *const ring = rxRing();
+        (void) QMetaObject::invokeMethod(_worker, [this, channel, ring] {
+            _worker->setFramingChannel(channel, ring);
+        }, Qt::QueuedConnection);
+    }
+
     return QMetaObject::invokeMethod(_worker, "connectToPort", Qt::QueuedConnection);
 }
 
+void SerialLink::_freeMavlinkChannel()
+{
+    if (_workerFraming) {
+        // The worker parses with our channel, make sure it is done before the channel is recycled
+        (void) QMetaObject::invokeMethod(_worker, [this] {
+            _worker->setFramingChannel(nullptr, nullptr);
+        }, Qt::BlockingQueuedConnection);
+        _workerFraming = false;
+    }
+
+    LinkInterface::_freeMavlinkChannel();
+}
+
 void SerialLink::disconnect()
 {
     (void) QMetaObject::invokeMethod(_worker, "disconnectFromPort", Qt::QueuedConnection);
@@ -9,9 +9,16 @@
 
 #pragma once
 
+#include <QtCore/QByteArray>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QString>
 
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+
 #ifdef Q_OS_ANDROID
 #include "qserialport.h"
 #else
@@ -21,8 +28,10 @@
 #include "linkconfiguration.h"
 #include "linkinterface.h"
 
-class QThread;
+class QSocketNotifier;
 class QTimer;
+class SerialUringEngine;
+class TermiosSerialPort;
 
 Q_DECLARE_LOGGING_CATEGORY(SerialLinkLog)
 
@@ -39,8 +48,19 @@ class SerialConfiguration : public LinkConfiguration
     Q_PROPERTY(QString                  portName        READ portName        WRITE setPortName    NOTIFY portNameChanged)
     Q_PROPERTY(QString                  portDisplayName READ portDisplayName                      NOTIFY portDisplayNameChanged)
     Q_PROPERTY(bool                     usbDirect       READ usbDirect       WRITE setUsbDirect   NOTIFY usbDirectChanged)
+    Q_PROPERTY(bool                     lowLatency      READ lowLatency      WRITE setLowLatency  NOTIFY lowLatencyChanged)
+    Q_PROPERTY(int                      usbLatencyTimer READ usbLatencyTimer WRITE setUsbLatencyTimer NOTIFY usbLatencyTimerChanged)
+    Q_PROPERTY(int                      txQueueMs       READ txQueueMs       WRITE setTxQueueMs   NOTIFY txQueueMsChanged)
+    Q_PROPERTY(TxOverflowPolicy         txOverflowPolicy READ txOverflowPolicy WRITE setTxOverflowPolicy NOTIFY txOverflowPolicyChanged)
 
 public:
+    /// What a full transmit queue does with one more frame
+    enum TxOverflowPolicy {
+        TxDropNewest,   ///< The new frame is dropped
+        TxCoalesce,     ///< The new frame replaces a queued copy of the same message, else the oldest queued frame is dropped
+    };
+    Q_ENUM(TxOverflowPolicy)
+
     explicit SerialConfiguration(const QString &name, QObject *parent = nullptr);
     explicit SerialConfiguration(const SerialConfiguration *copy, QObject *parent = nullptr);
     virtual ~SerialConfiguration();
@@ -76,6 +96,22 @@ public:
     bool usbDirect() const { return _usbDirect; }
     void setUsbDirect(bool usbDirect) { if (usbDirect != _usbDirect) { _usbDirect = usbDirect; emit usbDirectChanged(); } }
 
+    /// Linux: drive the port through termios directly, with the driver's low latency flag and the USB latency timer set
+    bool lowLatency() const { return _lowLatency; }
+    void setLowLatency(bool lowLatency) { if (lowLatency != _lowLatency) { _lowLatency = lowLatency; emit lowLatencyChanged(); } }
+
+    /// Latency timer in ms for FTDI style USB adapters in low latency mode, 0 leaves the driver default
+    int usbLatencyTimer() const { return _usbLatencyTimer; }
+    void setUsbLatencyTimer(int latencyMs) { if (latencyMs != _usbLatencyTimer) { _usbLatencyTimer = latencyMs; emit usbLatencyTimerChanged(); } }
+
+    /// Outbound frames are paced to the baud rate and at most this much airtime is queued, 0 writes
+    /// everything at once. Ignored for usbDirect ports, their baud rate is not the line rate.
+    int txQueueMs() const { return _txQueueMs; }
+    void setTxQueueMs(int queueMs) { if (queueMs != _txQueueMs) { _txQueueMs = queueMs; emit txQueueMsChanged(); } }
+
+    TxOverflowPolicy txOverflowPolicy() const { return _txOverflowPolicy; }
+    void setTxOverflowPolicy(TxOverflowPolicy policy) { if (policy != _txOverflowPolicy) { _txOverflowPolicy = policy; emit txOverflowPolicyChanged(); } }
+
     static QStringList supportedBaudRates();
     static QString cleanPortDisplayName(const QString &name);
 
@@ -88,6 +124,10 @@ signals:
     void portNameChanged();
     void portDisplayNameChanged();
     void usbDirectChanged();
+    void lowLatencyChanged();
+    void usbLatencyTimerChanged();
+    void txQueueMsChanged();
+    void txOverflowPolicyChanged();
 
 private:
     qint32 _baud = QSerialPort::Baud57600;
@@ -98,6 +138,118 @@ private:
     QString _portName;
     QString _portDisplayName;
     bool _usbDirect = false;
+    bool _lowLatency = false;
+    int _usbLatencyTimer = 1;
+    int _txQueueMs = 250;
+    TxOverflowPolicy _txOverflowPolicy = TxCoalesce;
+};
+
+/*===========================================================================*/
+
+/// Bounded outbound queue of one serial link, paced to what the line can carry. Frames are handed to
+/// the port no faster than the byte rate of the configured baud, so the OS and adapter buffers stay
+/// shallow and a queued frame waits at most the configured airtime. Urgent frames (commands, mode
+/// changes, manual control) have their own lane which is always served first, so they never sit behind
+/// queued telemetry. Broadcast messages without a target can be coalesced when the queue is full: the
+/// newer copy takes the place of the queued one from the same component.
+/// Worker thread only, except stats().
+class SerialTxQueue
+{
+public:
+    struct Stats_t {
+        int depthFrames = 0;
+        qint64 depthBytes = 0;
+        qint64 peakDepthBytes = 0;
+        quint64 sentFrames = 0;
+        quint64 droppedFrames = 0;              ///< Queue full, per the overflow policy
+        quint64 coalescedFrames = 0;            ///< Replaced by a newer copy while queued
+        quint64 failedFrames = 0;               ///< The port refused them
+    };
+
+    SerialTxQueue();
+
+    /// @param bytesPerSecond 0 turns pacing off, everything is written at once
+    void configure(qint64 bytesPerSecond, int maxQueueMs, SerialConfiguration::TxOverflowPolicy policy);
+
+    /// Queues one MAVLink frame, urgent or not
+    ///     @return false: dropped
+    bool enqueueFrame(const char *data, qint64 length);
+    /// Queues bytes that are not a single frame, they are never coalesced
+    bool enqueueRaw(const char *data, qint64 length);
+
+    /// Calls write(const QByteArray &bytes) for queued frames, urgent first, while the byte budget lasts.
+    /// A write returning false counts the frame as failed and ends the round.
+    ///     @return ms until the next frame may go, -1 when the queue is empty
+    template<typename Write>
+    int service(Write &&write)
+    {
+        _refill();
+        while (_budget > 0) {
+            std::deque<Frame_t> &lane = !_urgent.empty() ? _urgent : _normal;
+            if (lane.empty()) {
+                break;
+            }
+            const Frame_t &frame = lane.front();
+            const bool written = write(frame.bytes);
+            if (_bytesPerSecond > 0) {
+                _budget -= frame.bytes.size();
+            }
+            _pop(lane, written);
+            if (!written) {
+                return _retryMs;
+            }
+        }
+        return _nextServiceMs();
+    }
+
+    void clear();
+    bool isEmpty() const { return _urgent.empty() && _normal.empty(); }
+
+    /// Any thread
+    Stats_t stats() const;
+
+    /// Line bytes per second for baud and framing, start and stop bits included
+    static qint64 lineRate(qint32 baud, int dataBits, bool parity, int stopBits);
+
+private:
+    struct Frame_t {
+        QByteArray bytes;
+        quint64 key = 0;                        ///< msgid, sysid and compid of coalescable frames
+        bool coalescable = false;
+    };
+
+    bool _enqueue(Frame_t &&frame, bool urgent);
+    /// Makes room for frame in the normal lane per policy
+    ///     @return false: frame is dropped, true: it may be queued, or it already replaced a queued copy
+    bool _overflow(Frame_t &frame, bool &replaced);
+    void _pop(std::deque<Frame_t> &lane, bool written);
+    void _refill();
+    int _nextServiceMs() const;
+    void _updateDepth();
+
+    std::deque<Frame_t> _urgent;
+    std::deque<Frame_t> _normal;
+    qint64 _normalBytes = 0;
+    qint64 _urgentBytes = 0;
+
+    qint64 _bytesPerSecond = 0;
+    qint64 _maxQueueBytes = 0;
+    SerialConfiguration::TxOverflowPolicy _policy = SerialConfiguration::TxCoalesce;
+    double _budget = 1;                         ///< Bytes the line can take now, negative while the last write is still going out
+    double _maxBudget = 1;
+    QElapsedTimer _clock;
+    qint64 _lastRefillNs = 0;
+
+    std::atomic<int> _depthFrames{0};
+    std::atomic<qint64> _depthBytes{0};
+    std::atomic<qint64> _peakDepthBytes{0};
+    std::atomic<quint64> _sentFrames{0};
+    std::atomic<quint64> _droppedFrames{0};
+    std::atomic<quint64> _coalescedFrames{0};
+    std::atomic<quint64> _failedFrames{0};
+
+    static constexpr int _retryMs = 10;
+    static constexpr int _burstMs = 5;          ///< Budget that may build up while idle
 };
 
 /*===========================================================================*/
@@ -112,19 +264,30 @@ public:
 
     bool isConnected() const;
     const QSerialPort *port() const { return _port; }
+    /// Lives in the worker thread, any thread may push
+    MAVLinkTxQueue *txQueue() const { return _txQueue; }
+    /// Any thread
+    SerialTxQueue::Stats_t txStats() const { return _pacedQueue.stats(); }
 
 signals:
     void connected();
     void disconnected();
     void dataReceived(const QByteArray &data);
+    /// Bytes the port accepted, once per service round
     void dataSent(const QByteArray &data);
     void errorOccurred(const QString &errorString);
 
 public slots:
-    void setupPort();
+    /// @param hotplugEvents true: portRemoved() is wired to SerialHotplugMonitor, the port is not polled
+    void setupPort(bool hotplugEvents = false);
     void connectToPort();
     void disconnectFromPort();
     void writeData(const QByteArray &data);
+    /// Disconnects if systemLocation is the open port
+    void portRemoved(const QString &systemLocation);
+    /// Frames received bytes on this thread with channel and pushes the frames into ring instead of
+    /// emitting dataReceived. nullptr turns framing off.
+    void setFramingChannel(MAVLinkChannel *channel, MAVLinkFrameRing *ring) { _framingChannel = channel; _rxRing = ring; }
 
 private slots:
     void _onPortConnected();
@@ -133,12 +296,43 @@ private slots:
     void _onPortBytesWritten(qint64 bytes) const;
     void _onPortErrorOccurred(QSerialPort::SerialPortError portError);
     void _checkPortAvailability();
+    void _onTxReady();
+    void _onNativeReadyRead();
+    void _onNativeReadyWrite();
+    void _onUringReady();
+    void _serviceTxQueue();
 
 private:
+    /// @return Bytes written, -1 after emitting errorOccurred
+    qint64 _write(const char *data, qint64 length);
+    /// Frames the bytes or hands them on raw
+    void _processReceived(const char *data, qint64 size);
+    /// Opens the port through TermiosSerialPort, false leaves it to QSerialPort
+    bool _openNative();
+    void _closeNative();
+    /// Reports a failed read or write of the native port and closes it
+    void _onNativeError(const QString &errorString);
+
     const SerialConfiguration *_serialConfig = nullptr;
     QSerialPort *_port = nullptr;
-    QTimer *_timer = nullptr;
+    QTimer *_timer = nullptr;                           ///< Polls for the port going away, without hotplug events only
     bool _errorEmitted = false;
+    MAVLinkChannel *_framingChannel = nullptr;
+    MAVLinkFrameRing *_rxRing = nullptr;
+    MAVLinkTxQueue *_txQueue = nullptr;
+    std::unique_ptr<TermiosSerialPort> _nativePort;     ///< Open in low latency mode only
+    QSocketNotifier *_nativeReadNotifier = nullptr;
+    QSocketNotifier *_nativeWriteNotifier = nullptr;
+    std::unique_ptr<SerialUringEngine> _uringEngine;    ///< Instead of the native notifiers when io_uring is enabled and available
+    QSocketNotifier *_uringNotifier = nullptr;
+    std::vector<char> _readBuffer;                      ///< Reused by every framed read
+    SerialTxQueue _pacedQueue;                          ///< Between _txQueue and the port
+    QByteArray _sentBytes;                              ///< Written during the current service round
+    QTimer *_txTimer = nullptr;
+
+    static constexpr size_t _txQueueSlots = 512;
+    static constexpr size_t _readBufferSize = 4096;
+    static constexpr const char *_ioUringKey = "serialIoUring";
 };
 
 /*===========================================================================*/
@@ -155,6 +349,7 @@ public:
     bool isSecureConnection() const override { return true; }
 
     const QSerialPort *port() const { return _worker->port(); }
+    SerialTxQueue::Stats_t txStats() const { return _worker->txStats(); }
 
 public slots:
     void disconnect() override;
@@ -166,11 +361,14 @@ private slots:
     void _onDataSent(const QByteArray &data);
     void _onErrorOccurred(const QString &errorString);
 
+protected:
+    void _freeMavlinkChannel() override;
+
 private:
     bool _connect() override;
     void _writeBytes(const QByteArray &data) override;
 
     const SerialConfiguration *_serialConfig = nullptr;
-    SerialWorker *_worker = nullptr;
-    QThread *_workerThread = nullptr;
+    SerialWorker *_worker = nullptr;  ///< Runs on a LinkIOThreadPool thread
+    bool _workerFraming = false;
 };
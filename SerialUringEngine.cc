@@ -0,0 +1,314 @@
+#include "SerialUringEngine.h"
+#include "IoUring.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QLoggingCategory>
+
+#ifdef QGC_IO_URING_AVAILABLE
+#include <poll.h>
+#include <sys/uio.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+Q_DECLARE_LOGGING_CATEGORY(SerialLinkLog)
+
+#ifdef QGC_IO_URING_AVAILABLE
+
+namespace {
+    // A linked poll and read, a linked poll and write, with room to spare
+    constexpr unsigned RING_ENTRIES = 8;
+    constexpr unsigned COMPLETION_ENTRIES = 16;
+
+    enum Request_t : uint64_t {
+        READ_POLL = 1,
+        READ,
+        WRITE_POLL,
+        WRITE,
+    };
+
+    enum Buffer_t : uint16_t {
+        READ_BUFFER = 0,
+        WRITE_BUFFER,
+    };
+}
+
+struct SerialUringEngine::Rings_t
+{
+    IoUring ring;
+
+    bool readArmed = false;
+    qint64 writeLength = 0;                     ///< Bytes waiting in writeBuffer, the first writeInFlight of them are being written
+    qint64 writeInFlight = 0;
+    QByteArray spill;                           ///< Written bytes writeBuffer had no room for, in order behind it
+
+    /// Moves spilled bytes into the room the last write made
+    void refill()
+    {
+        const qint64 length = qMin<qint64>(spill.size(), writeBufferSize - writeLength);
+        if (length <= 0) {
+            return;
+        }
+        (void) memcpy(writeBuffer + writeLength, spill.constData(), static_cast<size_t>(length));
+        writeLength += length;
+        (void) spill.remove(0, static_cast<int>(length));
+    }
+
+    char readBuffer[readBufferSize];
+    char writeBuffer[writeBufferSize];
+};
+
+SerialUringEngine::SerialUringEngine()
+{
+}
+
+SerialUringEngine::~SerialUringEngine()
+{
+    close();
+}
+
+bool SerialUringEngine::isSupported()
+{
+    return true;
+}
+
+bool SerialUringEngine::open(int fd)
+{
+    close();
+
+    _rings = new Rings_t;
+    Rings_t &r = *_rings;
+
+    if (!r.ring.open(RING_ENTRIES, COMPLETION_ENTRIES)) {
+        (void) _fail(QStringLiteral("io_uring setup"), errno);
+        qCDebug(SerialLinkLog) << "io_uring not available:" << _errorString;
+        close();
+        return false;
+    }
+
+    // Pinned once here, instead of on every read and write
+    const iovec buffers[] = {
+        { r.readBuffer, sizeof(r.readBuffer) },
+        { r.writeBuffer, sizeof(r.writeBuffer) },
+    };
+    if (r.ring.registerResource(IORING_REGISTER_BUFFERS, buffers, 2) < 0) {
+        (void) _fail(QStringLiteral("io_uring buffer registration"), errno);
+        qCDebug(SerialLinkLog) << "io_uring registered buffers not available:" << _errorString;
+        close();
+        return false;
+    }
+
+    _fd = fd;
+    if (!_armRead() || !r.ring.submit()) {
+        (void) _fail(QStringLiteral("io_uring read"), errno);
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void SerialUringEngine::close()
+{
+    if (_rings) {
+        Rings_t &r = *_rings;
+        if (_fd >= 0) {
+            // Closing the ring cancels asynchronously, the descriptor would stay in use a little longer
+            io_uring_sync_cancel_reg cancel{};
+            cancel.fd = _fd;
+            cancel.flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+            cancel.timeout.tv_sec = -1;
+            cancel.timeout.tv_nsec = -1;
+            (void) r.ring.registerResource(IORING_REGISTER_SYNC_CANCEL, &cancel, 1);
+        }
+        r.ring.close();
+        delete _rings;
+        _rings = nullptr;
+    }
+    _fd = -1;
+}
+
+bool SerialUringEngine::isOpen() const
+{
+    return (_rings != nullptr);
+}
+
+int SerialUringEngine::eventFd() const
+{
+    return _rings ? _rings->ring.eventFd() : -1;
+}
+
+void SerialUringEngine::write(const char *data, qint64 length)
+{
+    Rings_t &r = *_rings;
+
+    // Behind the bytes in flight, which the kernel reads from the front of the buffer
+    const qint64 buffered = r.spill.isEmpty() ? qMin<qint64>(length, writeBufferSize - r.writeLength) : 0;
+    (void) memcpy(r.writeBuffer + r.writeLength, data, static_cast<size_t>(buffered));
+    r.writeLength += buffered;
+    if (buffered < length) {
+        (void) r.spill.append(data + buffered, static_cast<int>(length - buffered));
+    }
+}
+
+qint64 SerialUringEngine::bytesToWrite() const
+{
+    return _rings ? (_rings->writeLength + _rings->spill.size()) : 0;
+}
+
+bool SerialUringEngine::submit()
+{
+    Rings_t &r = *_rings;
+    if ((r.writeInFlight == 0) && (r.writeLength > 0) && !_armWrite()) {
+        return _fail(QStringLiteral("io_uring write"), EBUSY);
+    }
+    if (!r.ring.submit()) {
+        return _fail(QStringLiteral("io_uring submit"), errno);
+    }
+    return true;
+}
+
+int SerialUringEngine::reap(const ReadCallback &callback)
+{
+    if (!isOpen()) {
+        return -1;
+    }
+
+    Rings_t &r = *_rings;
+    int reads = 0;
+    bool failed = false;
+
+    (void) r.ring.reap([this, &r, &callback, &reads, &failed](const io_uring_cqe &cqe) {
+        switch (cqe.user_data) {
+        case READ:
+            r.readArmed = false;
+            if (cqe.res > 0) {
+                callback(r.readBuffer, cqe.res);
+                reads++;
+            } else if (cqe.res == 0) {
+                // End of file, the device is gone
+                _errorString = QStringLiteral("Device disconnected");
+                failed = true;
+            } else if ((cqe.res != -EAGAIN) && (cqe.res != -EINTR)) {
+                (void) _fail(QStringLiteral("read"), -cqe.res);
+                failed = true;
+            }
+            break;
+        case WRITE:
+            if (cqe.res >= 0) {
+                // A short write leaves the rest at the front for the next one
+                r.writeLength -= cqe.res;
+                (void) memmove(r.writeBuffer, r.writeBuffer + cqe.res, static_cast<size_t>(r.writeLength));
+                r.refill();
+            } else if ((cqe.res != -EAGAIN) && (cqe.res != -EINTR)) {
+                r.writeLength = 0;
+                r.spill.clear();
+                (void) _fail(QStringLiteral("write"), -cqe.res);
+                failed = true;
+            }
+            r.writeInFlight = 0;
+            break;
+        default:
+            // Polls only gate the linked read or write, which reports any trouble
+            break;
+        }
+        return !failed;
+    });
+    if (failed) {
+        return -1;
+    }
+
+    if (!r.readArmed && !_armRead()) {
+        (void) _fail(QStringLiteral("io_uring read"), EBUSY);
+        return -1;
+    }
+    if (!submit()) {
+        return -1;
+    }
+
+    return reads;
+}
+
+bool SerialUringEngine::_armRead()
+{
+    Rings_t &r = *_rings;
+
+    io_uring_sqe *const poll = r.ring.nextSqe();
+    io_uring_sqe *const read = poll ? r.ring.nextSqe() : nullptr;
+    if (!read) {
+        return false;
+    }
+
+    poll->opcode = IORING_OP_POLL_ADD;
+    poll->fd = _fd;
+    poll->poll32_events = POLLIN;
+    poll->flags = IOSQE_IO_LINK;
+    poll->user_data = READ_POLL;
+
+    read->opcode = IORING_OP_READ_FIXED;
+    read->fd = _fd;
+    read->addr = reinterpret_cast<uintptr_t>(r.readBuffer);
+    read->len = sizeof(r.readBuffer);
+    read->off = static_cast<uint64_t>(-1);
+    read->buf_index = READ_BUFFER;
+    read->user_data = READ;
+
+    r.readArmed = true;
+    return true;
+}
+
+bool SerialUringEngine::_armWrite()
+{
+    Rings_t &r = *_rings;
+
+    io_uring_sqe *const poll = r.ring.nextSqe();
+    io_uring_sqe *const write = poll ? r.ring.nextSqe() : nullptr;
+    if (!write) {
+        return false;
+    }
+
+    poll->opcode = IORING_OP_POLL_ADD;
+    poll->fd = _fd;
+    poll->poll32_events = POLLOUT;
+    poll->flags = IOSQE_IO_LINK;
+    poll->user_data = WRITE_POLL;
+
+    write->opcode = IORING_OP_WRITE_FIXED;
+    write->fd = _fd;
+    write->addr = reinterpret_cast<uintptr_t>(r.writeBuffer);
+    write->len = static_cast<uint32_t>(r.writeLength);
+    write->off = static_cast<uint64_t>(-1);
+    write->buf_index = WRITE_BUFFER;
+    write->user_data = WRITE;
+
+    r.writeInFlight = r.writeLength;
+    return true;
+}
+
+bool SerialUringEngine::_fail(const QString &what, int error)
+{
+    _errorString = QStringLiteral("%1 failed: %2").arg(what, QString::fromLocal8Bit(strerror(error)));
+    return false;
+}
+
+#else
+
+struct SerialUringEngine::Rings_t {};
+
+SerialUringEngine::SerialUringEngine() {}
+SerialUringEngine::~SerialUringEngine() {}
+bool SerialUringEngine::isSupported() { return false; }
+bool SerialUringEngine::open(int) { return false; }
+void SerialUringEngine::close() {}
+bool SerialUringEngine::isOpen() const { return false; }
+int SerialUringEngine::eventFd() const { return -1; }
+void SerialUringEngine::write(const char *, qint64) {}
+qint64 SerialUringEngine::bytesToWrite() const { return 0; }
+bool SerialUringEngine::submit() { return false; }
+int SerialUringEngine::reap(const ReadCallback &) { return -1; }
+bool SerialUringEngine::_armRead() { return false; }
+bool SerialUringEngine::_armWrite() { return false; }
+bool SerialUringEngine::_fail(const QString &, int) { return false; }
+
+#endif
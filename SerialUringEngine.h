@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QtGlobal>
+
+#include <functional>
+
+/// io_uring read and write engine for a tty opened by TermiosSerialPort, which keeps owning the descriptor.
+/// Reads and writes go through buffers registered with the kernel once, each armed as a poll linked to a
+/// fixed buffer read or write, so the non-blocking tty is only touched once it is ready. The read is
+/// re-armed and the next write started in the same io_uring_enter(), and completions are reaped from
+/// shared memory: one syscall per wakeup in steady state, whatever the number of frames written.
+/// Built without <linux/io_uring.h>, or where the kernel refuses the setup, open() fails and the caller
+/// keeps its socket notifiers.
+class SerialUringEngine
+{
+public:
+    SerialUringEngine();
+    ~SerialUringEngine();
+
+    SerialUringEngine(const SerialUringEngine&) = delete;
+    SerialUringEngine &operator=(const SerialUringEngine&) = delete;
+
+    static constexpr int readBufferSize = 4096;
+    static constexpr int writeBufferSize = 64 * 1024;
+
+    static bool isSupported();
+
+    /// Sets up the ring and the buffers and arms the read on fd
+    bool open(int fd);
+    /// Cancels what is in flight on the descriptor, call it before the descriptor closes
+    void close();
+    bool isOpen() const;
+
+    /// Becomes readable when completions are waiting
+    int eventFd() const;
+
+    /// Copies data behind the bytes already waiting, submit() starts writing them. What the registered
+    /// buffer has no room for waits in a heap copy, like the bytes TermiosSerialPort::write() keeps.
+    void write(const char *data, qint64 length);
+    qint64 bytesToWrite() const;
+
+    /// Starts writing the waiting bytes unless a write is in flight
+    ///     @return false on error
+    bool submit();
+
+    typedef std::function<void(const char *data, qint64 size)> ReadCallback;
+
+    /// Calls callback for every completed read, re-arms the read and carries on writing
+    ///     @return Number of reads, -1 on error or when the device went away
+    int reap(const ReadCallback &callback);
+
+    QString errorString() const { return _errorString; }
+
+private:
+    bool _armRead();
+    bool _armWrite();
+    bool _fail(const QString &what, int error);
+
+    struct Rings_t;
+    Rings_t *_rings = nullptr;                  ///< Set while open
+    int _fd = -1;
+    QString _errorString;
+};
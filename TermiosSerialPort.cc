@@ -0,0 +1,311 @@
+#include "TermiosSerialPort.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <linux/serial.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+#ifdef Q_OS_LINUX
+
+namespace {
+    struct BaudRate_t {
+        qint32 baud;
+        speed_t speed;
+    };
+
+    constexpr BaudRate_t BAUD_RATES[] = {
+        { 50, B50 }, { 75, B75 }, { 110, B110 }, { 134, B134 }, { 150, B150 }, { 200, B200 }, { 300, B300 },
+        { 600, B600 }, { 1200, B1200 }, { 1800, B1800 }, { 2400, B2400 }, { 4800, B4800 }, { 9600, B9600 },
+        { 19200, B19200 }, { 38400, B38400 }, { 57600, B57600 }, { 115200, B115200 }, { 230400, B230400 },
+        { 460800, B460800 }, { 500000, B500000 }, { 576000, B576000 }, { 921600, B921600 },
+        { 1000000, B1000000 }, { 1152000, B1152000 }, { 1500000, B1500000 }, { 2000000, B2000000 },
+        { 2500000, B2500000 }, { 3000000, B3000000 }, { 3500000, B3500000 }, { 4000000, B4000000 },
+    };
+
+    bool speedFor(qint32 baud, speed_t &speed)
+    {
+        for (const BaudRate_t &rate : BAUD_RATES) {
+            if (rate.baud == baud) {
+                speed = rate.speed;
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+TermiosSerialPort::TermiosSerialPort()
+{
+}
+
+TermiosSerialPort::~TermiosSerialPort()
+{
+    close();
+}
+
+bool TermiosSerialPort::isSupported()
+{
+    return true;
+}
+
+bool TermiosSerialPort::open(const QString &systemLocation)
+{
+    close();
+
+    _systemLocation = systemLocation;
+    _fd = ::open(QFile::encodeName(systemLocation).constData(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (_fd < 0) {
+        return _fail(QStringLiteral("open"));
+    }
+
+    // Same as QSerialPort, a second opener gets EBUSY instead of stealing bytes
+    if (ioctl(_fd, TIOCEXCL) < 0) {
+        (void) _fail(QStringLiteral("TIOCEXCL"));
+        close();
+        return false;
+    }
+
+    termios tio;
+    if (tcgetattr(_fd, &tio) < 0) {
+        (void) _fail(QStringLiteral("tcgetattr"));
+        close();
+        return false;
+    }
+    cfmakeraw(&tio);
+    tio.c_cflag |= CREAD | CLOCAL;
+    // With O_NONBLOCK an empty read fails with EAGAIN, so a read of 0 bytes only ever means hangup
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    if (tcsetattr(_fd, TCSANOW, &tio) < 0) {
+        (void) _fail(QStringLiteral("tcsetattr"));
+        close();
+        return false;
+    }
+
+    (void) tcflush(_fd, TCIOFLUSH);
+
+    return true;
+}
+
+void TermiosSerialPort::close()
+{
+    if (_fd >= 0) {
+        (void) ::close(_fd);
+        _fd = -1;
+    }
+    _pending.clear();
+}
+
+bool TermiosSerialPort::configure(qint32 baud, QSerialPort::DataBits dataBits, QSerialPort::Parity parity, QSerialPort::StopBits stopBits, QSerialPort::FlowControl flowControl)
+{
+    termios tio;
+    if (tcgetattr(_fd, &tio) < 0) {
+        return _fail(QStringLiteral("tcgetattr"));
+    }
+
+    speed_t speed;
+    if (!speedFor(baud, speed)) {
+        _errorString = QStringLiteral("Unsupported baud rate %1").arg(baud);
+        return false;
+    }
+    (void) cfsetispeed(&tio, speed);
+    (void) cfsetospeed(&tio, speed);
+
+    tio.c_cflag &= ~CSIZE;
+    switch (dataBits) {
+    case QSerialPort::Data5:
+        tio.c_cflag |= CS5;
+        break;
+    case QSerialPort::Data6:
+        tio.c_cflag |= CS6;
+        break;
+    case QSerialPort::Data7:
+        tio.c_cflag |= CS7;
+        break;
+    default:
+        tio.c_cflag |= CS8;
+        break;
+    }
+
+    tio.c_cflag &= ~(PARENB | PARODD | CMSPAR);
+    switch (parity) {
+    case QSerialPort::EvenParity:
+        tio.c_cflag |= PARENB;
+        break;
+    case QSerialPort::OddParity:
+        tio.c_cflag |= PARENB | PARODD;
+        break;
+    case QSerialPort::SpaceParity:
+        tio.c_cflag |= PARENB | CMSPAR;
+        break;
+    case QSerialPort::MarkParity:
+        tio.c_cflag |= PARENB | CMSPAR | PARODD;
+        break;
+    default:
+        break;
+    }
+
+    if (stopBits == QSerialPort::TwoStop) {
+        tio.c_cflag |= CSTOPB;
+    } else {
+        tio.c_cflag &= ~CSTOPB;
+    }
+
+    tio.c_cflag &= ~CRTSCTS;
+    tio.c_iflag &= ~(IXON | IXOFF | IXANY);
+    if (flowControl == QSerialPort::HardwareControl) {
+        tio.c_cflag |= CRTSCTS;
+    } else if (flowControl == QSerialPort::SoftwareControl) {
+        tio.c_iflag |= IXON | IXOFF;
+    }
+
+    if (tcsetattr(_fd, TCSANOW, &tio) < 0) {
+        return _fail(QStringLiteral("tcsetattr"));
+    }
+
+    return true;
+}
+
+bool TermiosSerialPort::setDataTerminalReady(bool set)
+{
+    int bits = TIOCM_DTR;
+    if (ioctl(_fd, set ? TIOCMBIS : TIOCMBIC, &bits) < 0) {
+        return _fail(set ? QStringLiteral("TIOCMBIS") : QStringLiteral("TIOCMBIC"));
+    }
+    return true;
+}
+
+bool TermiosSerialPort::setLowLatency(bool enable)
+{
+    serial_struct serial;
+    if (ioctl(_fd, TIOCGSERIAL, &serial) < 0) {
+        // Ptys and some CDC ACM drivers have no serial_struct, nothing to tune there
+        return _fail(QStringLiteral("TIOCGSERIAL"));
+    }
+
+    if (enable) {
+        serial.flags |= ASYNC_LOW_LATENCY;
+    } else {
+        serial.flags &= ~ASYNC_LOW_LATENCY;
+    }
+    if (ioctl(_fd, TIOCSSERIAL, &serial) < 0) {
+        return _fail(QStringLiteral("TIOCSSERIAL"));
+    }
+
+    return true;
+}
+
+bool TermiosSerialPort::setUsbLatencyTimer(int latencyMs)
+{
+    // ftdi_sio and friends publish it next to the tty, /dev/ttyUSB0 -> /sys/class/tty/ttyUSB0/device/latency_timer
+    const QString ttyName = QFileInfo(QFileInfo(_systemLocation).canonicalFilePath()).fileName();
+    QFile latencyTimer(QStringLiteral("/sys/class/tty/%1/device/latency_timer").arg(ttyName));
+    if (!latencyTimer.exists()) {
+        _errorString = QStringLiteral("%1 has no USB latency timer").arg(ttyName);
+        return false;
+    }
+
+    if (!latencyTimer.open(QIODevice::WriteOnly) || (latencyTimer.write(QByteArray::number(latencyMs)) < 0)) {
+        _errorString = latencyTimer.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+qint64 TermiosSerialPort::read(char *data, qint64 maxLength)
+{
+    const ssize_t bytesRead = ::read(_fd, data, static_cast<size_t>(maxLength));
+    if (bytesRead > 0) {
+        return bytesRead;
+    }
+    if (bytesRead == 0) {
+        // End of file, the device is gone
+        _errorString = QStringLiteral("Device disconnected");
+        return -1;
+    }
+    if ((errno == EAGAIN) || (errno == EINTR)) {
+        return 0;
+    }
+    (void) _fail(QStringLiteral("read"));
+    return -1;
+}
+
+bool TermiosSerialPort::write(const char *data, qint64 length)
+{
+    qint64 written = 0;
+    if (_pending.isEmpty()) {
+        while (written < length) {
+            const ssize_t result = ::write(_fd, data + written, static_cast<size_t>(length - written));
+            if (result > 0) {
+                written += result;
+            } else if ((result < 0) && (errno == EINTR)) {
+                continue;
+            } else if ((result < 0) && (errno != EAGAIN)) {
+                return _fail(QStringLiteral("write"));
+            } else {
+                break;
+            }
+        }
+    }
+
+    if (written < length) {
+        (void) _pending.append(data + written, static_cast<int>(length - written));
+    }
+
+    return true;
+}
+
+bool TermiosSerialPort::flush()
+{
+    qint64 written = 0;
+    while (written < _pending.size()) {
+        const ssize_t result = ::write(_fd, _pending.constData() + written, static_cast<size_t>(_pending.size() - written));
+        if (result > 0) {
+            written += result;
+        } else if ((result < 0) && (errno == EINTR)) {
+            continue;
+        } else if ((result < 0) && (errno != EAGAIN)) {
+            _pending.clear();
+            return _fail(QStringLiteral("write"));
+        } else {
+            break;
+        }
+    }
+    (void) _pending.remove(0, static_cast<int>(written));
+
+    return true;
+}
+
+bool TermiosSerialPort::_fail(const QString &what)
+{
+    _errorString = QStringLiteral("%1 failed: %2").arg(what, QString::fromLocal8Bit(strerror(errno)));
+    return false;
+}
+
+#else
+
+TermiosSerialPort::TermiosSerialPort() {}
+TermiosSerialPort::~TermiosSerialPort() {}
+bool TermiosSerialPort::isSupported() { return false; }
+bool TermiosSerialPort::open(const QString &) { return false; }
+void TermiosSerialPort::close() {}
+bool TermiosSerialPort::configure(qint32, QSerialPort::DataBits, QSerialPort::Parity, QSerialPort::StopBits, QSerialPort::FlowControl) { return false; }
+bool TermiosSerialPort::setDataTerminalReady(bool) { return false; }
+bool TermiosSerialPort::setLowLatency(bool) { return false; }
+bool TermiosSerialPort::setUsbLatencyTimer(int) { return false; }
+qint64 TermiosSerialPort::read(char *, qint64) { return -1; }
+bool TermiosSerialPort::write(const char *, qint64) { return false; }
+bool TermiosSerialPort::flush() { return false; }
+bool TermiosSerialPort::_fail(const QString &) { return false; }
+
+#endif
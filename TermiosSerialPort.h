@@ -0,0 +1,66 @@
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+#ifdef Q_OS_ANDROID
+#include "qserialport.h"
+#else
+#include <QtSerialPort/QSerialPort>
+#endif
+
+/// Serial port opened and configured directly through termios, for when QSerialPort's latency is in
+/// the way: raw mode with O_NONBLOCK, the driver's ASYNC_LOW_LATENCY flag, the USB latency timer of
+/// FTDI style adapters and reads straight into the caller's buffer. The owner watches fd() for
+/// readability, and for writability while bytesToWrite() is not zero.
+/// Linux only, isSupported() is false elsewhere and open() always fails.
+class TermiosSerialPort
+{
+public:
+    TermiosSerialPort();
+    ~TermiosSerialPort();
+
+    TermiosSerialPort(const TermiosSerialPort&) = delete;
+    TermiosSerialPort &operator=(const TermiosSerialPort&) = delete;
+
+    static bool isSupported();
+
+    /// Opens the tty exclusively, in raw mode and without becoming its controlling terminal
+    bool open(const QString &systemLocation);
+    void close();
+    bool isOpen() const { return (_fd >= 0); }
+    int fd() const { return _fd; }
+
+    bool configure(qint32 baud, QSerialPort::DataBits dataBits, QSerialPort::Parity parity, QSerialPort::StopBits stopBits, QSerialPort::FlowControl flowControl);
+    bool setDataTerminalReady(bool set);
+
+    /// Asks the driver to push received bytes to the tty layer at once instead of batching them (TIOCSSERIAL)
+    bool setLowLatency(bool enable);
+
+    /// Sets the latency timer of a USB serial adapter through sysfs, when it has one and we may write it
+    bool setUsbLatencyTimer(int latencyMs);
+
+    /// Reads whatever is waiting, without blocking
+    ///     @return Bytes read, 0 if nothing was waiting, -1 on error or when the device went away
+    qint64 read(char *data, qint64 maxLength);
+
+    /// Writes what the tty takes now and keeps the rest for flush()
+    ///     @return false on error, nothing of data is kept then
+    bool write(const char *data, qint64 length);
+
+    /// Writes kept bytes the tty takes now
+    ///     @return false on error
+    bool flush();
+
+    qint64 bytesToWrite() const { return _pending.size(); }
+
+    QString errorString() const { return _errorString; }
+
+private:
+    bool _fail(const QString &what);
+
+    int _fd = -1;
+    QString _systemLocation;
+    QByteArray _pending;
+    QString _errorString;
+};
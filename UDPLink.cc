@@ -8,15 +8,27 @@
  ****************************************************************************/
 
 #include "UDPLink.h"
+#include "MAVLinkChannel.h"
+#include "UDPReceiveBatch.h"
+#include "UDPSendBatch.h"
+#include "UDPUringReceiver.h"
+#include "LinkIOThreadPool.h"
+#include "mavlinkprotocol.h"
 
 
 #include <QtCore/QMutexLocker>
-#include <QtCore/QThread>
+#include <QtCore/QSettings>
+#include <QtCore/QSocketNotifier>
+#include <QtCore/QTimer>
 #include <QtNetwork/QHostInfo>
 #include <QtNetwork/QNetworkDatagram>
 #include <QtNetwork/QNetworkInterface>
 #include <QtNetwork/QNetworkProxy>
 #include <QtNetwork/QUdpSocket>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
 Q_LOGGING_CATEGORY(UDPLinkLog, "UDPLinkLog")
 
 
@@ -38,6 +50,251 @@ namespace {
 
 /*===========================================================================*/
 
+UDPSenderChannels::UDPSenderChannels()
+{
+    _clock.start();
+}
+
+UDPSenderChannels::~UDPSenderChannels()
+{
+    clear();
+}
+
+void UDPSenderChannels::setLinkChannel(const MAVLinkChannel *linkChannel)
+{
+    if (!linkChannel) {
+        clear();
+    }
+    _linkChannel = linkChannel;
+    updateSigning();
+}
+
+void UDPSenderChannels::updateSigning()
+{
+    for (const Sender_t &sender : std::as_const(_senders)) {
+        _copySigning(sender.channel);
+    }
+}
+
+MAVLinkChannel *UDPSenderChannels::channel(const QHostAddress &address, quint16 port)
+{
+    if (!_linkChannel) {
+        return nullptr;
+    }
+
+    const qint64 now = _clock.elapsed();
+    if ((now - _lastSweepMSecs) >= _sweepIntervalMSecs) {
+        _expire(now);
+    }
+
+    const UDPClient key(address, port);
+    const auto it = _senders.find(key);
+    if (it != _senders.end()) {
+        it->lastSeenMSecs = now;
+        return it->channel;
+    }
+
+    if (_senders.size() >= _maxSenders) {
+        auto oldest = _senders.begin();
+        for (auto candidate = _senders.begin(); candidate != _senders.end(); ++candidate) {
+            if (candidate->lastSeenMSecs < oldest->lastSeenMSecs) {
+                oldest = candidate;
+            }
+        }
+        qCDebug(UDPLinkLog) << "Sender table full, dropping" << oldest.key().address << oldest.key().port;
+        MAVLinkChannelPool::instance()->release(oldest->channel);
+        (void) _senders.erase(oldest);
+    }
+
+    Sender_t sender;
+    sender.channel = MAVLinkChannelPool::instance()->allocate();
+    sender.lastSeenMSecs = now;
+    _copySigning(sender.channel);
+    (void) _senders.insert(key, sender);
+    qCDebug(UDPLinkLog) << "New sender" << address << port << "channel" << sender.channel->id;
+
+    return sender.channel;
+}
+
+void UDPSenderChannels::clear()
+{
+    MAVLinkChannelPool *const pool = MAVLinkChannelPool::instance();
+    for (const Sender_t &sender : std::as_const(_senders)) {
+        if (pool) {
+            pool->release(sender.channel);
+        }
+    }
+    _senders.clear();
+}
+
+void UDPSenderChannels::_expire(qint64 nowMSecs)
+{
+    _lastSweepMSecs = nowMSecs;
+
+    for (auto it = _senders.begin(); it != _senders.end();) {
+        if ((nowMSecs - it->lastSeenMSecs) > _senderTimeoutMSecs) {
+            qCDebug(UDPLinkLog) << "Sender timed out" << it.key().address << it.key().port;
+            MAVLinkChannelPool::instance()->release(it->channel);
+            it = _senders.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void UDPSenderChannels::_copySigning(MAVLinkChannel *channel) const
+{
+    // Sender channels sign and check with the state of the link, under its lock
+    QMutex *const mutex = _linkChannel ? _linkChannel->parser.signingMutex() : nullptr;
+    QMutexLocker locker(mutex);
+    channel->parser.setSigningMutex(mutex);
+    channel->status.signing = _linkChannel ? _linkChannel->status.signing : nullptr;
+    channel->status.signing_streams = _linkChannel ? _linkChannel->status.signing_streams : nullptr;
+}
+
+/*===========================================================================*/
+
+UDPDestinationTable::UDPDestinationTable()
+    : _published(std::make_shared<const Snapshot_t>())
+    , _current(_published)
+{
+    _clock.start();
+}
+
+void UDPDestinationTable::setConfiguredTargets(const QList<std::shared_ptr<UDPClient>> &targets)
+{
+    QMutexLocker locker(&_writeMutex);
+    _configured.clear();
+    for (const std::shared_ptr<UDPClient> &target : targets) {
+        _configured.push_back(*target);
+    }
+    _publish();
+}
+
+bool UDPDestinationTable::touchSessionTarget(const QHostAddress &address, quint16 port)
+{
+    const qint64 now = _clock.elapsed();
+    if ((now - _lastSweepMSecs) >= _sweepIntervalMSecs) {
+        expireSessionTargets();
+    }
+
+    const UDPClient key(address, port);
+    const auto it = _sessionLastSeen.find(key);
+    if (it != _sessionLastSeen.end()) {
+        it.value() = now;
+        return false;
+    }
+
+    if (_sessionLastSeen.size() >= _maxSessionTargets) {
+        auto oldest = _sessionLastSeen.begin();
+        for (auto candidate = _sessionLastSeen.begin(); candidate != _sessionLastSeen.end(); ++candidate) {
+            if (candidate.value() < oldest.value()) {
+                oldest = candidate;
+            }
+        }
+        qCDebug(UDPLinkLog) << "Session target table full, dropping" << oldest.key().address << oldest.key().port;
+        (void) _sessionLastSeen.erase(oldest);
+        (void) _evictedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    (void) _sessionLastSeen.insert(key, now);
+    (void) _addedCount.fetch_add(1, std::memory_order_relaxed);
+    _publishSession();
+    return true;
+}
+
+void UDPDestinationTable::expireSessionTargets()
+{
+    const qint64 now = _clock.elapsed();
+    _lastSweepMSecs = now;
+
+    bool changed = false;
+    for (auto it = _sessionLastSeen.begin(); it != _sessionLastSeen.end();) {
+        if ((now - it.value()) > _sessionTimeoutMSecs) {
+            qCDebug(UDPLinkLog) << "Session target timed out" << it.key().address << it.key().port;
+            it = _sessionLastSeen.erase(it);
+            (void) _expiredCount.fetch_add(1, std::memory_order_relaxed);
+            changed = true;
+        } else {
+            ++it;
+        }
+    }
+
+    if (changed) {
+        _publishSession();
+    }
+}
+
+void UDPDestinationTable::clearSessionTargets()
+{
+    if (_sessionLastSeen.isEmpty()) {
+        return;
+    }
+    _sessionLastSeen.clear();
+    _publishSession();
+}
+
+QList<UDPClient> UDPDestinationTable::sessionTargets() const
+{
+    QMutexLocker locker(&_writeMutex);
+    QList<UDPClient> targets;
+    targets.reserve(static_cast<int>(_session.size()));
+    for (const UDPClient &target : _session) {
+        targets.append(target);
+    }
+    return targets;
+}
+
+UDPDestinationTable::SessionStats_t UDPDestinationTable::sessionStats() const
+{
+    SessionStats_t stats;
+    {
+        QMutexLocker locker(&_writeMutex);
+        stats.active = static_cast<int>(_session.size());
+    }
+    stats.added = _addedCount.load(std::memory_order_relaxed);
+    stats.expired = _expiredCount.load(std::memory_order_relaxed);
+    stats.evicted = _evictedCount.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void UDPDestinationTable::_publishSession()
+{
+    QMutexLocker locker(&_writeMutex);
+    _session.clear();
+    for (auto it = _sessionLastSeen.cbegin(); it != _sessionLastSeen.cend(); ++it) {
+        _session.push_back(it.key());
+    }
+    _publish();
+}
+
+void UDPDestinationTable::_publish()
+{
+    const std::shared_ptr<Snapshot_t> snapshot = std::make_shared<Snapshot_t>();
+    snapshot->destinations = _session;
+    snapshot->sessionCount = static_cast<int>(_session.size());
+    for (const UDPClient &target : _configured) {
+        if (std::find(_session.cbegin(), _session.cend(), target) == _session.cend()) {
+            snapshot->destinations.push_back(target);
+        }
+    }
+    snapshot->generation = _generation.load(std::memory_order_relaxed) + 1;
+
+    _published = snapshot;
+    _generation.store(snapshot->generation, std::memory_order_release);
+}
+
+const UDPDestinationTable::Snapshot_t &UDPDestinationTable::snapshot()
+{
+    if (_generation.load(std::memory_order_acquire) != _current->generation) {
+        QMutexLocker locker(&_writeMutex);
+        _current = _published;
+    }
+    return *_current;
+}
+
+/*===========================================================================*/
+
 UDPConfiguration::UDPConfiguration(const QString &name, QObject *parent)
     : LinkConfiguration(name, parent)
 {
@@ -67,6 +324,7 @@ void UDPConfiguration::copyFrom(const LinkConfiguration *source)
     Q_ASSERT(udpSource);
 
     setLocalPort(udpSource->localPort());
+    setMaxSendLatencyMs(udpSource->maxSendLatencyMs());
     _targetHosts.clear();
 
     for (const std::shared_ptr<UDPClient> &target : udpSource->targetHosts()) {
@@ -74,6 +332,8 @@ void UDPConfiguration::copyFrom(const LinkConfiguration *source)
             _targetHosts.append(std::make_shared<UDPClient>(target.get()));
         }
     }
+
+    emit targetHostsChanged();
 }
 
 void UDPConfiguration::loadSettings(QSettings &settings, const QString &root)
@@ -81,6 +341,7 @@ void UDPConfiguration::loadSettings(QSettings &settings, const QString &root)
     settings.beginGroup(root);
 
     setLocalPort(static_cast<quint16>(settings.value("port", "5000").toUInt()));
+    setMaxSendLatencyMs(settings.value("maxSendLatencyMs", 0).toInt());
 
     _targetHosts.clear();
     const qsizetype hostCount = settings.value("hostCount", 0).toUInt();
@@ -91,6 +352,7 @@ void UDPConfiguration::loadSettings(QSettings &settings, const QString &root)
             addHost(settings.value(hkey).toString(), settings.value(pkey).toUInt());
         }
     }
+    emit targetHostsChanged();
 
     settings.endGroup();
 }
@@ -101,6 +363,7 @@ void UDPConfiguration::saveSettings(QSettings &settings, const QString &root) co
 
     settings.setValue(QStringLiteral("hostCount"), _targetHosts.size());
     settings.setValue(QStringLiteral("port"), _localPort);
+    settings.setValue(QStringLiteral("maxSendLatencyMs"), _maxSendLatencyMs);
 
     for (qsizetype i = 0; i < _targetHosts.size(); i++) {
         const std::shared_ptr<UDPClient> target = _targetHosts.at(i);
@@ -142,6 +405,7 @@ void UDPConfiguration::addHost(const QString &host, quint16 port)
     const QHostAddress address(ipAdd);
     if (!containsTarget(_targetHosts, address, port)) {
         _targetHosts.append(std::make_shared<UDPClient>(address, port));
+        emit targetHostsChanged();
     }
 }
 
@@ -166,6 +430,7 @@ void UDPConfiguration::removeHost(const QString &host)
             const std::shared_ptr<UDPClient> &target = _targetHosts[i];
             if (target->address == address && target->port == port) {
                 _targetHosts.removeAt(i);
+                emit targetHostsChanged();
                 return;
             }
         }
@@ -192,6 +457,7 @@ void UDPConfiguration::removeHost(const QString &host, quint16 port)
         const std::shared_ptr<UDPClient> &target = _targetHosts[i];
         if (target->address == address && target->port == port) {
             _targetHosts.removeAt(i);
+            emit targetHostsChanged();
             return;
         }
     }
@@ -228,8 +494,17 @@ const QHostAddress UDPWorker::_multicastGroup = QHostAddress(QStringLiteral("224
 UDPWorker::UDPWorker(const UDPConfiguration *config, QObject *parent)
     : QObject(parent)
     , _udpConfig(config)
+    , _txQueue(new MAVLinkTxQueue(_txQueueSlots, this))
 {
     // qCDebug(UDPLinkLog) << Q_FUNC_INFO << this;
+
+    // Published on the thread editing the configuration, picked up by the next send
+    _destinations.setConfiguredTargets(_udpConfig->targetHosts());
+    (void) connect(_udpConfig, &UDPConfiguration::targetHostsChanged, this, [this] {
+        _destinations.setConfiguredTargets(_udpConfig->targetHosts());
+    }, Qt::DirectConnection);
+
+    (void) connect(_txQueue, &MAVLinkTxQueue::readyWrite, this, &UDPWorker::_onTxReady);
 }
 
 UDPWorker::~UDPWorker()
@@ -258,6 +533,30 @@ void UDPWorker::setupSocket()
 
     _socket->setProxy(QNetworkProxy::NoProxy);
 
+    if (UDPReceiveBatch::isSupported()) {
+        _receiveBatch = std::make_unique<UDPReceiveBatch>();
+    }
+
+    // Opt in, the ring is only set up once the socket is bound
+    if (UDPUringReceiver::isSupported() && QSettings().value(_ioUringKey, false).toBool()) {
+        _uringReceiver = std::make_unique<UDPUringReceiver>();
+    }
+
+    if (UDPSendBatch::isSupported()) {
+        _sendBatch = std::make_unique<UDPSendBatch>();
+        _sendFlushTimer = new QTimer(this);
+        _sendFlushTimer->setSingleShot(true);
+        _sendFlushTimer->setTimerType(Qt::PreciseTimer);
+        (void) connect(_sendFlushTimer, &QTimer::timeout, this, &UDPWorker::_flushSendBatch);
+    }
+
+    // Senders that went quiet stop being sent to even while nothing else is received
+    _sessionExpiryTimer = new QTimer(this);
+    (void) connect(_sessionExpiryTimer, &QTimer::timeout, this, [this] {
+        _destinations.expireSessionTargets();
+    });
+    _sessionExpiryTimer->start(1000);
+
     (void) connect(_socket, &QUdpSocket::connected, this, &UDPWorker::_onSocketConnected);
     (void) connect(_socket, &QUdpSocket::disconnected, this, &UDPWorker::_onSocketDisconnected);
     (void) connect(_socket, &QUdpSocket::readyRead, this, &UDPWorker::_onSocketReadyRead);
@@ -318,6 +617,20 @@ void UDPWorker::connectLink()
         return;
     }
 
+    if (_sendBatch) {
+        _sendBatch->setSocket(_socket->socketDescriptor());
+        _sendBatchGeneration = 0;
+        qCDebug(UDPLinkLog) << "Batched send, GSO" << _sendBatch->gsoEnabled();
+    }
+
+    if (_uringReceiver && !_startUring()) {
+        qCDebug(UDPLinkLog) << "io_uring receive not available, using socket reads";
+        _uringReceiver.reset();
+    }
+    if (!_uringReceiver) {
+        _startBatchReceive();
+    }
+
     qCDebug(UDPLinkLog) << "Attempting to join multicast group:" << _multicastGroup.toString();
     const bool joinSuccess = _socket->joinMulticastGroup(_multicastGroup);
     if (!joinSuccess) {
@@ -337,12 +650,29 @@ void UDPWorker::disconnectLink()
     _deregisterZeroconf();
 #endif
 
+    _stopUring();
+    _stopBatchReceive();
+
     if (isConnected()) {
+        if (_sendBatch) {
+            _flushSendBatch();
+        }
         (void) _socket->leaveMulticastGroup(_multicastGroup);
         _socket->close();
     }
 
-    _sessionTargets.clear();
+    _destinations.clearSessionTargets();
+}
+
+void UDPWorker::setFramingChannel(const MAVLinkChannel *linkChannel, MAVLinkFrameRing *ring)
+{
+    _framingChannels.setLinkChannel(linkChannel);
+    _rxRing = linkChannel ? ring : nullptr;
+}
+
+void UDPWorker::updateFramingSigning()
+{
+    _framingChannels.updateSigning();
 }
 
 void UDPWorker::writeData(const QByteArray &data)
@@ -352,33 +682,99 @@ void UDPWorker::writeData(const QByteArray &data)
         return;
     }
 
-    QMutexLocker locker(&_sessionTargetsMutex);
+    // Frames queued or still batched were written before this one and go first
+    _onTxReady();
+    if (_sendBatch) {
+        _flushSendBatch();
+    }
 
-    // Send to all manually targeted systems
-    for (const std::shared_ptr<UDPClient> &target : _udpConfig->targetHosts()) {
-        if (!containsTarget(_sessionTargets, target->address, target->port)) {
-            if (_socket->writeDatagram(data, target->address, target->port) < 0) {
-                qCWarning(UDPLinkLog) << "Could Not Send Data - Write Failed!";
-            }
+    _sendToTargets(data.constData(), data.size());
+
+    emit dataSent(data);
+}
+
+void UDPWorker::_onTxReady()
+{
+    if (!isConnected()) {
+        const int dropped = _txQueue->drain([](const char *, size_t) {});
+        if (dropped > 0) {
+            emit errorOccurred(tr("Could Not Send Data - Link is Disconnected!"));
         }
+        return;
     }
 
-    // Send to all connected systems
-    for (const std::shared_ptr<UDPClient> &target: _sessionTargets) {
-        if (_socket->writeDatagram(data, target->address, target->port) < 0) {
-            qCWarning(UDPLinkLog) << "Could Not Send Data - Write Failed!";
+    if (const uint64_t dropped = _txQueue->takeOverflows()) {
+        qCWarning(UDPLinkLog) << "Outbound queue full," << dropped << "frames dropped";
+    }
+
+    if (!_sendBatch) {
+        QByteArray sent;
+        (void) _txQueue->drain([this, &sent](const char *data, size_t length) {
+            _sendToTargets(data, static_cast<qint64>(length));
+            (void) sent.append(data, static_cast<qsizetype>(length));
+        });
+        if (!sent.isEmpty()) {
+            emit dataSent(sent);
         }
+        return;
     }
 
-    locker.unlock();
+    bool urgent = false;
+    (void) _txQueue->drain([this, &urgent](const char *data, size_t length) {
+        if (!_sendBatch->append(data, length)) {
+            _flushSendBatch();
+            (void) _sendBatch->append(data, length);
+        }
+        // Commands and manual control go out at once, whatever the send latency setting
+        urgent = urgent || MAVLinkTxQueue::isUrgentFrame(data, length);
+    });
 
-    emit dataSent(data);
+    const int maxLatencyMs = _udpConfig->maxSendLatencyMs();
+    if (urgent || (maxLatencyMs <= 0) || _sendBatch->isFull()) {
+        _flushSendBatch();
+    } else if (!_sendBatch->isEmpty() && !_sendFlushTimer->isActive()) {
+        _sendFlushTimer->start(maxLatencyMs);
+    }
+}
+
+void UDPWorker::_flushSendBatch()
+{
+    _sendFlushTimer->stop();
+    if (_sendBatch->isEmpty()) {
+        return;
+    }
+
+    // The sockaddr list of the batch is only rebuilt when a new snapshot was published
+    const UDPDestinationTable::Snapshot_t &snapshot = _destinations.snapshot();
+    if (snapshot.generation != _sendBatchGeneration) {
+        _sendBatch->clearDestinations();
+        for (const UDPClient &destination : snapshot.destinations) {
+            _sendBatch->addDestination(destination.address, destination.port);
+        }
+        _sendBatchGeneration = snapshot.generation;
+    }
+
+    // Reported once per flush, like writeData() reports once per write
+    const QByteArray sent(_sendBatch->data(), static_cast<qsizetype>(_sendBatch->byteCount()));
+    (void) _sendBatch->flush();
+    emit dataSent(sent);
+}
+
+void UDPWorker::_sendToTargets(const char *data, qint64 length)
+{
+    // Connected systems and manually targeted systems, deduplicated by the snapshot
+    for (const UDPClient &destination : _destinations.snapshot().destinations) {
+        if (_socket->writeDatagram(data, length, destination.address, destination.port) < 0) {
+            qCWarning(UDPLinkLog) << "Could Not Send Data - Write Failed!";
+        }
+    }
 }
 
 void UDPWorker::_onSocketConnected()
 {
     qCDebug(UDPLinkLog) << "UDP connected to" << _udpConfig->localPort();
     _isConnected = true;
+    _txQueue->setOpen(true);
     _errorEmitted = false;
     emit connected();
 }
@@ -387,6 +783,7 @@ void UDPWorker::_onSocketDisconnected()
 {
     qCDebug(UDPLinkLog) << "UDP disconnected from" << _udpConfig->localPort();
     _isConnected = false;
+    _txQueue->setOpen(false);
     _errorEmitted = false;
     emit disconnected();
 }
@@ -412,22 +809,174 @@ void UDPWorker::_onSocketReadyRead()
         QNetworkDatagram datagramIn = _socket->receiveDatagram();
         if (datagramIn.isNull() || datagramIn.data().isEmpty()) continue;
 
-        // --- 核心修正：直接發送，不緩衝 ---
-        emit dataReceived(datagramIn.data());
+        const QByteArray data = datagramIn.data();
+        const quint16 senderPort = static_cast<quint16>(datagramIn.senderPort());
+        _processDatagram(data.constData(), data.size(), datagramIn.senderAddress(), senderPort, &data);
+        _touchSessionTarget(datagramIn.senderAddress(), senderPort);
+    }
+}
+
+void UDPWorker::_receiveBatched()
+{
+    if (!isConnected()) {
+        emit errorOccurred(tr("Could Not Read Data - Link is Disconnected!"));
+        return;
+    }
+
+    int count;
+    do {
+        count = _receiveBatch->receive();
+        if (count < 0) {
+            qCWarning(UDPLinkLog) << "recvmmsg failed, falling back to QUdpSocket reads:" << strerror(errno);
+            _stopBatchReceive();
+            _receiveBatch.reset();
+            // Whatever is still waiting goes through Qt, which also re-arms its notifier
+            _onSocketReadyRead();
+            return;
+        }
+
+        for (int i = 0; i < count; i++) {
+            if (_receiveBatch->isTruncated(i)) {
+                qCWarning(UDPLinkLog) << "Datagram longer than" << UDPReceiveBatch::bufferSize << "bytes truncated";
+            }
+            if (_receiveBatch->size(i) > 0) {
+                _processDatagram(_receiveBatch->data(i), _receiveBatch->size(i), _receiveBatch->senderAddress(i), _receiveBatch->senderPort(i));
+            }
+        }
+
+        // Consecutive datagrams of the same sender are looked up once
+        for (int i = 0; i < count; i++) {
+            if ((i == 0) || !_receiveBatch->sameSender(i, i - 1)) {
+                _touchSessionTarget(_receiveBatch->senderAddress(i), _receiveBatch->senderPort(i));
+            }
+        }
+    } while (count == UDPReceiveBatch::batchSize);
+}
+
+void UDPWorker::_startBatchReceive()
+{
+    if (!_receiveBatch) {
+        return;
+    }
+    if (!_receiveBatch->open(_socket->socketDescriptor())) {
+        qCWarning(UDPLinkLog) << "recvmmsg not available, using QUdpSocket reads:" << strerror(errno);
+        _receiveBatch.reset();
+        return;
+    }
 
-        // 更新 Session Targets
-        const QHostAddress senderAddress = (datagramIn.senderAddress().isLoopback() || _localAddresses.contains(datagramIn.senderAddress()))
-                                               ? QHostAddress(QHostAddress::LocalHost)
-                                               : datagramIn.senderAddress();
+    // recvmmsg takes every datagram, the first one included. Qt's own notifier turns itself off after
+    // a readyRead nobody answers with a read.
+    (void) disconnect(_socket, &QUdpSocket::readyRead, this, &UDPWorker::_onSocketReadyRead);
 
-        QMutexLocker locker(&_sessionTargetsMutex);
-        if (!containsTarget(_sessionTargets, senderAddress, datagramIn.senderPort())) {
-            qCDebug(UDPLinkLog) << "UDP Adding target:" << senderAddress << datagramIn.senderPort();
-            _sessionTargets.append(std::make_shared<UDPClient>(senderAddress, datagramIn.senderPort()));
+    _receiveNotifier = new QSocketNotifier(_receiveBatch->descriptor(), QSocketNotifier::Read, this);
+    (void) connect(_receiveNotifier, &QSocketNotifier::activated, this, &UDPWorker::_receiveBatched);
+}
+
+void UDPWorker::_stopBatchReceive()
+{
+    if (!_receiveNotifier) {
+        return;
+    }
+
+    _receiveNotifier->setEnabled(false);
+    _receiveNotifier->deleteLater();
+    _receiveNotifier = nullptr;
+
+    _receiveBatch->close();
+    (void) connect(_socket, &QUdpSocket::readyRead, this, &UDPWorker::_onSocketReadyRead, Qt::UniqueConnection);
+}
+
+bool UDPWorker::_startUring()
+{
+    if (!_uringReceiver->open(_socket->socketDescriptor())) {
+        return false;
+    }
+
+    // The kernel now completes every datagram into the ring, the socket itself is never read again
+    (void) disconnect(_socket, &QUdpSocket::readyRead, this, &UDPWorker::_onSocketReadyRead);
+
+    _uringNotifier = new QSocketNotifier(_uringReceiver->eventFd(), QSocketNotifier::Read, this);
+    (void) connect(_uringNotifier, &QSocketNotifier::activated, this, &UDPWorker::_onUringReady);
+
+    qCDebug(UDPLinkLog) << "Receiving through io_uring";
+    return true;
+}
+
+void UDPWorker::_stopUring()
+{
+    if (!_uringNotifier) {
+        return;
+    }
+
+    _uringNotifier->setEnabled(false);
+    _uringNotifier->deleteLater();
+    _uringNotifier = nullptr;
+
+    // Before the socket closes, so the armed receive never outlives its descriptor
+    _uringReceiver->close();
+    (void) connect(_socket, &QUdpSocket::readyRead, this, &UDPWorker::_onSocketReadyRead, Qt::UniqueConnection);
+}
+
+void UDPWorker::_onUringReady()
+{
+    // Every sender is refreshed at least once per wakeup, like once per recvmmsg batch
+    bool firstDatagram = true;
+    const int count = _uringReceiver->reap([this, &firstDatagram](const char *data, qint64 size, const QHostAddress &senderAddress, quint16 senderPort, bool newSender, bool truncated) {
+        if (truncated) {
+            qCWarning(UDPLinkLog) << "Datagram longer than" << UDPUringReceiver::bufferSize << "bytes truncated";
+        }
+        if (size > 0) {
+            _processDatagram(data, size, senderAddress, senderPort);
+        }
+        if (newSender || firstDatagram) {
+            _touchSessionTarget(senderAddress, senderPort);
+            firstDatagram = false;
+        }
+    });
+
+    if (count < 0) {
+        qCWarning(UDPLinkLog) << "io_uring receive failed, falling back to QUdpSocket reads";
+        _stopUring();
+        _uringReceiver.reset();
+        // Whatever arrived since the ring closed is still on the socket
+        _startBatchReceive();
+        if (_receiveNotifier) {
+            _receiveBatched();
+        } else {
+            // This also re-arms Qt's notifier
+            _onSocketReadyRead();
         }
     }
 }
 
+void UDPWorker::_processDatagram(const char *data, qint64 size, const QHostAddress &senderAddress, quint16 senderPort, const QByteArray *shared)
+{
+    MAVLinkChannel *const framingChannel = _framingChannels.channel(senderAddress, senderPort);
+    if (framingChannel) {
+        (void) framingChannel->parser.parse(reinterpret_cast<const uint8_t*>(data), static_cast<size_t>(size), [this](const uint8_t *frame, size_t frameLength) {
+            if (!_rxRing->push(frame, frameLength)) {
+                qCDebug(UDPLinkLog) << "Receive ring full, frame dropped";
+            }
+        });
+    } else {
+        // --- 核心修正：直接發送，不緩衝 ---
+        emit dataReceived(shared ? *shared : QByteArray(data, static_cast<int>(size)), senderAddress, senderPort);
+    }
+}
+
+void UDPWorker::_touchSessionTarget(const QHostAddress &address, quint16 port)
+{
+    // 更新 Session Targets
+    const QHostAddress senderAddress = (address.isLoopback() || _localAddresses.contains(address))
+                                           ? QHostAddress(QHostAddress::LocalHost)
+                                           : address;
+
+    // Known senders only get their last seen time updated, no lock taken
+    if (_destinations.touchSessionTarget(senderAddress, port)) {
+        qCDebug(UDPLinkLog) << "UDP Adding target:" << senderAddress << port;
+    }
+}
+
 void UDPWorker::_onSocketBytesWritten(qint64 bytes)
 {
     qCDebug(UDPLinkLog) << "Wrote" << bytes << "bytes";
@@ -454,14 +1003,8 @@ UDPLink::UDPLink(SharedLinkConfigurationPtr &config, QObject *parent)
     : LinkInterface(config, parent)
     , _udpConfig(qobject_cast<const UDPConfiguration*>(config.get()))
     , _worker(new UDPWorker(_udpConfig))
-    , _workerThread(new QThread(this))
 {
-    _workerThread->setObjectName(QStringLiteral("UDP_%1").arg(_udpConfig->name()));
-
-    _worker->moveToThread(_workerThread);
-
-    (void) connect(_workerThread, &QThread::started, _worker, &UDPWorker::setupSocket);
-    (void) connect(_workerThread, &QThread::finished, _worker, &QObject::deleteLater);
+    _setTxQueue(_worker->txQueue());
 
     (void) connect(_worker, &UDPWorker::connected, this, &UDPLink::_onConnected, Qt::QueuedConnection);
     (void) connect(_worker, &UDPWorker::disconnected, this, &UDPLink::_onDisconnected, Qt::QueuedConnection);
@@ -469,17 +1012,18 @@ UDPLink::UDPLink(SharedLinkConfigurationPtr &config, QObject *parent)
     (void) connect(_worker, &UDPWorker::dataReceived, this, &UDPLink::_onDataReceived, Qt::QueuedConnection);
     (void) connect(_worker, &UDPWorker::dataSent, this, &UDPLink::_onDataSent, Qt::QueuedConnection);
 
-    _workerThread->start();
+    UDPWorker *const worker = _worker;
+    LinkIOThreadPool::instance()->attach(_worker, QStringLiteral("UDP_%1").arg(_udpConfig->name()), [worker] {
+        worker->setupSocket();
+    });
 }
 
 UDPLink::~UDPLink()
 {
     UDPLink::disconnect();
 
-    _workerThread->quit();
-    if (!_workerThread->wait()) {
-        qCWarning(UDPLinkLog) << "Failed to wait for UDP Thread to close";
-    }
+    _setTxQueue(nullptr);
+    LinkIOThreadPool::instance()->detach(_worker);
 
     // qCDebug(UDPLinkLog) << Q_FUNC_INFO << this;
 }
@@ -491,6 +1035,17 @@ bool UDPLink::isConnected() const
 
 bool UDPLink::_connect()
 {
+    _workerFraming = MAVLinkProtocol::instance()->workerFraming();
+    if (_workerFraming) {
+        const MAVLinkChannel *const linkChannel = mavlinkChannel();
+        MAVLinkFrameRing *const ring = rxRing();
+        (void) QMetaObject::invokeMethod(_worker, [this, linkChannel, ring] {
+            _worker->setFramingChannel(linkChannel, ring);
+        }, Qt::QueuedConnection);
+    } else {
+        _senderChannels.setLinkChannel(mavlinkChannel());
+    }
+
     return QMetaObject::invokeMethod(_worker, "connectLink", Qt::QueuedConnection);
 }
 
@@ -515,9 +1070,39 @@ void UDPLink::_onErrorOccurred(const QString &errorString)
     emit communicationError(tr("UDP Link Error"), tr("Link %1: %2").arg(_udpConfig->name(), errorString));
 }
 
-void UDPLink::_onDataReceived(const QByteArray &data)
+void UDPLink::_onDataReceived(const QByteArray &data, const QHostAddress &senderAddress, quint16 senderPort)
+{
+    MAVLinkChannel *const channel = _senderChannels.channel(senderAddress, senderPort);
+    if (channel) {
+        emit channelBytesReceived(this, channel, data);
+    } else {
+        emit bytesReceived(this, data);
+    }
+}
+
+void UDPLink::_freeMavlinkChannel()
 {
-    emit bytesReceived(this, data);
+    if (_workerFraming) {
+        // The worker parses with channels derived from ours, make sure it is done with them
+        (void) QMetaObject::invokeMethod(_worker, [this] {
+            _worker->setFramingChannel(nullptr, nullptr);
+        }, Qt::BlockingQueuedConnection);
+        _workerFraming = false;
+    }
+    _senderChannels.clear();
+    _senderChannels.setLinkChannel(nullptr);
+
+    LinkInterface::_freeMavlinkChannel();
+}
+
+void UDPLink::initMavlinkSigning()
+{
+    LinkInterface::initMavlinkSigning();
+
+    _senderChannels.updateSigning();
+    if (_workerFraming) {
+        (void) QMetaObject::invokeMethod(_worker, "updateFramingSigning", Qt::QueuedConnection);
+    }
 }
 
 void UDPLink::_onDataSent(const QByteArray &data)
@@ -10,19 +10,29 @@
 #pragma once
 
 #include <QtCore/QByteArray>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
 #include <QtCore/QList>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QMutex>
 #include <QtCore/QString>
 #include <QtNetwork/QHostAddress>
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 
 
 #include "linkconfiguration.h"
 #include "linkinterface.h"
 
+class QSocketNotifier;
 class QUdpSocket;
-class QThread;
+class QTimer;
+class UDPReceiveBatch;
+class UDPSendBatch;
+class UDPUringReceiver;
 
 Q_DECLARE_LOGGING_CATEGORY(UDPLinkLog)
 
@@ -57,6 +67,133 @@ struct UDPClient
     quint16 port = 0;
 };
 
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+inline size_t qHash(const UDPClient &client, size_t seed = 0)
+#else
+inline uint qHash(const UDPClient &client, uint seed = 0)
+#endif
+{
+    return qHash(client.address, seed) ^ client.port;
+}
+
+/*===========================================================================*/
+
+/// Parse channels of the remote senders of a UDP link, keyed by (address, port), so interleaved datagrams
+/// from several senders can't corrupt each other's partial frames. Holds at most _maxSenders, evicting the
+/// least recently seen sender when full, and drops senders silent for longer than _senderTimeoutMSecs.
+/// Sender channels share the signing setup of the link channel. Not thread safe, owned by one thread.
+class UDPSenderChannels
+{
+public:
+    UDPSenderChannels();
+    ~UDPSenderChannels();
+
+    /// Channel providing the signing setup, nullptr releases all sender channels and disables lookups
+    void setLinkChannel(const MAVLinkChannel *linkChannel);
+    const MAVLinkChannel *linkChannel() const { return _linkChannel; }
+
+    /// Reapplies the signing setup of the link channel to all sender channels
+    void updateSigning();
+
+    /// @return Parse channel of the sender, created on first use. nullptr while there is no link channel.
+    MAVLinkChannel *channel(const QHostAddress &address, quint16 port);
+
+    void clear();
+    int count() const { return _senders.size(); }
+
+private:
+    struct Sender_t {
+        MAVLinkChannel *channel = nullptr;
+        qint64 lastSeenMSecs = 0;
+    };
+
+    void _expire(qint64 nowMSecs);
+    void _copySigning(MAVLinkChannel *channel) const;
+
+    const MAVLinkChannel *_linkChannel = nullptr;
+    QHash<UDPClient, Sender_t> _senders;
+    QElapsedTimer _clock;
+    qint64 _lastSweepMSecs = 0;
+
+    static constexpr int _maxSenders = 64;
+    static constexpr qint64 _senderTimeoutMSecs = 30000;
+    static constexpr qint64 _sweepIntervalMSecs = 1000;
+};
+
+/*===========================================================================*/
+
+/// Destinations of a UDP link: the configured target hosts plus the session targets learned from
+/// received datagrams. Readers see an immutable, deduplicated snapshot. Writers build a new one and
+/// publish it by bumping a generation counter, RCU style, so the send path only does one atomic load
+/// per send and never locks or allocates unless the set changed. The previous snapshot stays alive
+/// until the reader picks up the new one.
+/// Session targets are hashed by (address, port) with their last seen time. Targets silent for longer
+/// than _sessionTimeoutMSecs expire, and at most _maxSessionTargets are kept, evicting the least
+/// recently seen one, so stale peers stop being sent to.
+/// Configured targets may be set from any thread. Session targets and snapshot() belong to the single
+/// reader (worker) thread. sessionTargets() and sessionStats() may be queried from any thread.
+class UDPDestinationTable
+{
+public:
+    struct Snapshot_t {
+        std::vector<UDPClient> destinations;    ///< Session targets first, then configured targets not already in there
+        int sessionCount = 0;
+        quint64 generation = 0;
+    };
+
+    struct SessionStats_t {
+        int active = 0;
+        quint64 added = 0;
+        quint64 expired = 0;                    ///< Dropped after being idle
+        quint64 evicted = 0;                    ///< Dropped to make room for a new sender
+    };
+
+    UDPDestinationTable();
+
+    void setConfiguredTargets(const QList<std::shared_ptr<UDPClient>> &targets);
+
+    /// Reader thread. Records traffic from the sender, making it a session target if it is not one yet.
+    ///     @return true: sender was added
+    bool touchSessionTarget(const QHostAddress &address, quint16 port);
+    /// Reader thread. Drops the session targets idle for too long, cheap to call often.
+    void expireSessionTargets();
+    /// Reader thread
+    void clearSessionTargets();
+
+    /// Reader thread only. Stays valid until the next call.
+    const Snapshot_t &snapshot();
+
+    /// Any thread. Remotes currently sent to as session targets.
+    QList<UDPClient> sessionTargets() const;
+    SessionStats_t sessionStats() const;
+
+private:
+    /// Caller holds _writeMutex
+    void _publish();
+    /// Copies the session keys for the writers and publishes
+    void _publishSession();
+
+    mutable QMutex _writeMutex;
+    std::vector<UDPClient> _configured;
+    std::vector<UDPClient> _session;
+    std::shared_ptr<const Snapshot_t> _published;
+    std::atomic<quint64> _generation{0};
+
+    // Reader thread
+    std::shared_ptr<const Snapshot_t> _current;
+    QHash<UDPClient, qint64> _sessionLastSeen;
+    QElapsedTimer _clock;
+    qint64 _lastSweepMSecs = 0;
+
+    std::atomic<quint64> _addedCount{0};
+    std::atomic<quint64> _expiredCount{0};
+    std::atomic<quint64> _evictedCount{0};
+
+    static constexpr int _maxSessionTargets = 32;
+    static constexpr qint64 _sessionTimeoutMSecs = 15000;
+    static constexpr qint64 _sweepIntervalMSecs = 1000;
+};
+
 /*===========================================================================*/
 
 class UDPConfiguration : public LinkConfiguration
@@ -64,6 +201,7 @@ class UDPConfiguration : public LinkConfiguration
     Q_OBJECT
 
     Q_PROPERTY(quint16 localPort READ localPort WRITE setLocalPort NOTIFY localPortChanged)
+    Q_PROPERTY(int maxSendLatencyMs READ maxSendLatencyMs WRITE setMaxSendLatencyMs NOTIFY maxSendLatencyMsChanged)
 
 public:
     explicit UDPConfiguration(const QString &name, QObject *parent = nullptr);
@@ -86,8 +224,16 @@ public:
     quint16 localPort() const { return _localPort; }
     void setLocalPort(quint16 port) { if (port != _localPort) { _localPort = port; emit localPortChanged(); } }
 
+    /// How long outbound frames may be held back to be sent in one batch, 0 sends every batch as soon as
+    /// it was drained. Commands and manual control are never held back.
+    int maxSendLatencyMs() const { return _maxSendLatencyMs; }
+    void setMaxSendLatencyMs(int latencyMs) { if (latencyMs != _maxSendLatencyMs) { _maxSendLatencyMs = latencyMs; emit maxSendLatencyMsChanged(); } }
+
 signals:
     void localPortChanged();
+    void maxSendLatencyMsChanged();
+    /// Emitted on the thread editing the configuration, after targetHosts() changed
+    void targetHostsChanged();
 
 private:
 
@@ -95,6 +241,7 @@ private:
 
     QList<std::shared_ptr<UDPClient>> _targetHosts;
     quint16 _localPort = 0;
+    int _maxSendLatencyMs = 0;
 };
 
 /*===========================================================================*/
@@ -108,18 +255,26 @@ public:
     virtual ~UDPWorker();
 
     bool isConnected() const;
+    /// Lives in the worker thread, any thread may push
+    MAVLinkTxQueue *txQueue() const { return _txQueue; }
+    /// sessionTargets() and sessionStats() may be called from any thread
+    const UDPDestinationTable &destinations() const { return _destinations; }
 
 public slots:
     void setupSocket();
     void connectLink();
     void disconnectLink();
     void writeData(const QByteArray &data);
+    /// Frames received datagrams on this thread with per sender channels and pushes the frames into ring
+    /// instead of emitting dataReceived. nullptr turns framing off and releases the sender channels.
+    void setFramingChannel(const MAVLinkChannel *linkChannel, MAVLinkFrameRing *ring);
+    void updateFramingSigning();
 
 signals:
     void connected();
     void disconnected();
     void errorOccurred(const QString &errorString);
-    void dataReceived(const QByteArray &data);
+    void dataReceived(const QByteArray &data, const QHostAddress &senderAddress, quint16 senderPort);
     void dataSent(const QByteArray &data);
 
 private slots:
@@ -128,16 +283,44 @@ private slots:
     void _onSocketReadyRead();
     void _onSocketBytesWritten(qint64 bytes);
     void _onSocketErrorOccurred(QAbstractSocket::SocketError socketError);
+    void _onTxReady();
+    void _flushSendBatch();
+    void _onUringReady();
 
 private:
+    void _sendToTargets(const char *data, qint64 length);
+    void _touchSessionTarget(const QHostAddress &address, quint16 port);
+    /// Frames the datagram or hands it on raw, shared avoids a copy when the caller already has a QByteArray
+    void _processDatagram(const char *data, qint64 size, const QHostAddress &senderAddress, quint16 senderPort, const QByteArray *shared = nullptr);
+    /// Drains everything still waiting on the socket with recvmmsg
+    void _receiveBatched();
+    /// Moves receiving off QUdpSocket's readyRead onto recvmmsg driven by _receiveNotifier
+    void _startBatchReceive();
+    void _stopBatchReceive();
+    /// Moves receiving off the QUdpSocket onto io_uring, false leaves the socket reads in place
+    bool _startUring();
+    void _stopUring();
+
     const UDPConfiguration *_udpConfig = nullptr;
     QUdpSocket *_socket = nullptr;
-    QMutex _sessionTargetsMutex;
-    QList<std::shared_ptr<UDPClient>> _sessionTargets;
+    UDPDestinationTable _destinations;
     bool _isConnected = false;
     bool _errorEmitted = false;
     QSet<QHostAddress> _localAddresses;
-
+    UDPSenderChannels _framingChannels;
+    MAVLinkFrameRing *_rxRing = nullptr;
+    MAVLinkTxQueue *_txQueue = nullptr;
+    std::unique_ptr<UDPReceiveBatch> _receiveBatch;     ///< nullptr where recvmmsg is not available
+    QSocketNotifier *_receiveNotifier = nullptr;        ///< Watches the descriptor of _receiveBatch
+    std::unique_ptr<UDPSendBatch> _sendBatch;           ///< nullptr where sendmmsg is not available
+    std::unique_ptr<UDPUringReceiver> _uringReceiver;   ///< nullptr unless io_uring receiving is enabled and available
+    QSocketNotifier *_uringNotifier = nullptr;
+    QTimer *_sendFlushTimer = nullptr;
+    QTimer *_sessionExpiryTimer = nullptr;
+    quint64 _sendBatchGeneration = 0;                   ///< Destination snapshot the send batch was built from, 0 for none
+
+    static constexpr size_t _txQueueSlots = 512;
+    static constexpr const char *_ioUringKey = "udpIoUring";
     static const QHostAddress _multicastGroup;
 
 
@@ -156,20 +339,27 @@ public:
     bool isConnected() const override;
     void disconnect() override;
     bool isSecureConnection() const override {return true;};
+    void initMavlinkSigning() override;
+
+    /// Remotes that sent to this link recently and receive its traffic, any thread
+    QList<UDPClient> sessionTargets() const { return _worker->destinations().sessionTargets(); }
+    UDPDestinationTable::SessionStats_t sessionStats() const { return _worker->destinations().sessionStats(); }
 
 protected:
     bool _connect() override;
+    void _freeMavlinkChannel() override;
 
 private slots:
     void _writeBytes(const QByteArray &data) override;
     void _onConnected();
     void _onDisconnected();
     void _onErrorOccurred(const QString &errorString);
-    void _onDataReceived(const QByteArray &data);
+    void _onDataReceived(const QByteArray &data, const QHostAddress &senderAddress, quint16 senderPort);
     void _onDataSent(const QByteArray &data);
 
 private:
     const UDPConfiguration *_udpConfig = nullptr;
-    UDPWorker *_worker = nullptr;
-    QThread *_workerThread = nullptr;
+    UDPWorker *_worker = nullptr;     ///< Runs on a LinkIOThreadPool thread
+    UDPSenderChannels _senderChannels;     ///< Used when framing on the main thread
+    bool _workerFraming = false;
 };
@@ -0,0 +1,144 @@
+#include "UDPReceiveBatch.h"
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#ifdef Q_OS_LINUX
+
+struct UDPReceiveBatch::Storage_t
+{
+    Storage_t()
+    {
+        for (int i = 0; i < batchSize; i++) {
+            iov[i].iov_base = buffers[i];
+            iov[i].iov_len = bufferSize;
+        }
+    }
+
+    void prepare()
+    {
+        // recvmmsg writes the actual lengths back, so every call starts from the full buffers again
+        (void) memset(messages, 0, sizeof(messages));
+        for (int i = 0; i < batchSize; i++) {
+            messages[i].msg_hdr.msg_name = &senders[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(senders[i]);
+            messages[i].msg_hdr.msg_iov = &iov[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+    }
+
+    char buffers[batchSize][bufferSize];
+    iovec iov[batchSize];
+    sockaddr_storage senders[batchSize];
+    mmsghdr messages[batchSize];
+};
+
+UDPReceiveBatch::UDPReceiveBatch()
+    : _storage(new Storage_t)
+{
+}
+
+UDPReceiveBatch::~UDPReceiveBatch()
+{
+    close();
+}
+
+bool UDPReceiveBatch::isSupported()
+{
+    return true;
+}
+
+bool UDPReceiveBatch::open(qintptr socketDescriptor)
+{
+    close();
+    _descriptor = fcntl(static_cast<int>(socketDescriptor), F_DUPFD_CLOEXEC, 0);
+    return isOpen();
+}
+
+void UDPReceiveBatch::close()
+{
+    if (_descriptor >= 0) {
+        (void) ::close(_descriptor);
+        _descriptor = -1;
+    }
+}
+
+int UDPReceiveBatch::receive()
+{
+    _cachedIndex = -1;
+    _storage->prepare();
+
+    const int count = recvmmsg(_descriptor, _storage->messages, batchSize, MSG_DONTWAIT, nullptr);
+    if (count < 0) {
+        return ((errno == EAGAIN) || (errno == EWOULDBLOCK)) ? 0 : -1;
+    }
+
+    return count;
+}
+
+const char *UDPReceiveBatch::data(int index) const
+{
+    return _storage->buffers[index];
+}
+
+qint64 UDPReceiveBatch::size(int index) const
+{
+    return qMin<qint64>(_storage->messages[index].msg_len, bufferSize);
+}
+
+bool UDPReceiveBatch::isTruncated(int index) const
+{
+    return (_storage->messages[index].msg_hdr.msg_flags & MSG_TRUNC);
+}
+
+const QHostAddress &UDPReceiveBatch::senderAddress(int index)
+{
+    if ((_cachedIndex < 0) || !sameSender(index, _cachedIndex)) {
+        _cachedAddress.setAddress(reinterpret_cast<const sockaddr*>(&_storage->senders[index]));
+    }
+    _cachedIndex = index;
+    return _cachedAddress;
+}
+
+quint16 UDPReceiveBatch::senderPort(int index) const
+{
+    const sockaddr_storage &sender = _storage->senders[index];
+    if (sender.ss_family == AF_INET6) {
+        return ntohs(reinterpret_cast<const sockaddr_in6*>(&sender)->sin6_port);
+    }
+    return ntohs(reinterpret_cast<const sockaddr_in*>(&sender)->sin_port);
+}
+
+bool UDPReceiveBatch::sameSender(int index, int otherIndex) const
+{
+    const socklen_t length = _storage->messages[index].msg_hdr.msg_namelen;
+    return (length == _storage->messages[otherIndex].msg_hdr.msg_namelen)
+        && (memcmp(&_storage->senders[index], &_storage->senders[otherIndex], length) == 0);
+}
+
+#else
+
+struct UDPReceiveBatch::Storage_t {};
+
+UDPReceiveBatch::UDPReceiveBatch() {}
+UDPReceiveBatch::~UDPReceiveBatch() {}
+bool UDPReceiveBatch::isSupported() { return false; }
+bool UDPReceiveBatch::open(qintptr) { return false; }
+void UDPReceiveBatch::close() {}
+int UDPReceiveBatch::receive() { return -1; }
+const char *UDPReceiveBatch::data(int) const { return nullptr; }
+qint64 UDPReceiveBatch::size(int) const { return 0; }
+bool UDPReceiveBatch::isTruncated(int) const { return false; }
+const QHostAddress &UDPReceiveBatch::senderAddress(int) { return _cachedAddress; }
+quint16 UDPReceiveBatch::senderPort(int) const { return 0; }
+bool UDPReceiveBatch::sameSender(int, int) const { return false; }
+
+#endif
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QtCore/QtGlobal>
+#include <QtNetwork/QHostAddress>
+
+#include <memory>
+
+/// Drains a UDP socket with one recvmmsg() call per batchSize datagrams into buffers allocated once,
+/// instead of one pendingDatagramSize()/receiveDatagram() pair and a QNetworkDatagram per datagram.
+/// Works on its own duplicate of the socket descriptor, so the caller can watch descriptor() with a
+/// QSocketNotifier of its own next to the one QUdpSocket keeps on the original, and never has to read
+/// through Qt to re-arm it. Linux only, isSupported() is false elsewhere and open() always fails.
+class UDPReceiveBatch
+{
+public:
+    UDPReceiveBatch();
+    ~UDPReceiveBatch();
+
+    UDPReceiveBatch(const UDPReceiveBatch&) = delete;
+    UDPReceiveBatch &operator=(const UDPReceiveBatch&) = delete;
+
+    static constexpr int batchSize = 32;
+    static constexpr int bufferSize = 4096;     ///< Longer datagrams are truncated, see isTruncated()
+
+    static bool isSupported();
+
+    /// Duplicates the socket descriptor to receive on
+    bool open(qintptr socketDescriptor);
+    void close();
+    bool isOpen() const { return (_descriptor >= 0); }
+
+    /// Becomes readable when datagrams are waiting, -1 while closed
+    int descriptor() const { return _descriptor; }
+
+    /// Receives up to batchSize waiting datagrams without blocking
+    ///     @return Number of datagrams received, 0 if none was waiting, -1 on error
+    int receive();
+
+    const char *data(int index) const;
+    qint64 size(int index) const;
+    bool isTruncated(int index) const;
+
+    /// The last converted sender is cached, so a batch from a single peer builds one QHostAddress
+    const QHostAddress &senderAddress(int index);
+    quint16 senderPort(int index) const;
+    bool sameSender(int index, int otherIndex) const;
+
+private:
+    struct Storage_t;
+    const std::unique_ptr<Storage_t> _storage;
+
+    int _descriptor = -1;
+    QHostAddress _cachedAddress;
+    int _cachedIndex = -1;
+};
@@ -0,0 +1,264 @@
+#include "UDPSendBatch.h"
+
+#include <QtCore/QLoggingCategory>
+
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#ifdef Q_OS_LINUX
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#endif
+
+Q_DECLARE_LOGGING_CATEGORY(UDPLinkLog)
+
+#ifdef Q_OS_LINUX
+
+namespace {
+    /// Kernel limit on the segments of one GSO message
+    constexpr int GSO_MAX_SEGMENTS = 64;
+
+    /// Sends the segments of a refused GSO message as one datagram each, to the same destination
+    ///     @return Number of datagrams the kernel refused
+    int sendSegments(int socketDescriptor, const msghdr &header)
+    {
+        uint16_t segmentLength;
+        (void) memcpy(&segmentLength, CMSG_DATA(CMSG_FIRSTHDR(&header)), sizeof(segmentLength));
+
+        const char *const data = static_cast<const char*>(header.msg_iov->iov_base);
+        const size_t length = header.msg_iov->iov_len;
+        const sockaddr *const destination = static_cast<const sockaddr*>(header.msg_name);
+
+        int failed = 0;
+        for (size_t offset = 0; offset < length; offset += segmentLength) {
+            ssize_t result;
+            do {
+                result = sendto(socketDescriptor, data + offset, segmentLength, 0, destination, header.msg_namelen);
+            } while ((result < 0) && (errno == EINTR));
+
+            if (result < 0) {
+                qCWarning(UDPLinkLog) << "Could Not Send Data - Write Failed!" << strerror(errno);
+                failed++;
+            }
+        }
+        return failed;
+    }
+}
+
+struct UDPSendBatch::Storage_t
+{
+    struct Control_t {
+        alignas(cmsghdr) char data[CMSG_SPACE(sizeof(uint16_t))];
+    };
+
+    char frames[maxFrames * maxFrameLength];
+    size_t offsets[maxFrames];
+    size_t lengths[maxFrames];
+
+    std::vector<sockaddr_storage> destinations;
+    std::vector<socklen_t> destinationLengths;
+
+    // Grow with the destination count only, reused by every flush
+    std::vector<mmsghdr> messages;
+    std::vector<iovec> iov;
+    std::vector<Control_t> control;
+};
+
+UDPSendBatch::UDPSendBatch()
+    : _storage(new Storage_t)
+{
+}
+
+UDPSendBatch::~UDPSendBatch()
+{
+}
+
+bool UDPSendBatch::isSupported()
+{
+    return true;
+}
+
+void UDPSendBatch::setSocket(qintptr socketDescriptor)
+{
+    _socketDescriptor = static_cast<int>(socketDescriptor);
+
+    int gsoSize = 0;
+    socklen_t optionLength = sizeof(gsoSize);
+    _gsoEnabled = (getsockopt(_socketDescriptor, SOL_UDP, UDP_SEGMENT, &gsoSize, &optionLength) == 0);
+}
+
+void UDPSendBatch::clearDestinations()
+{
+    _storage->destinations.clear();
+    _storage->destinationLengths.clear();
+}
+
+void UDPSendBatch::addDestination(const QHostAddress &address, quint16 port)
+{
+    sockaddr_storage destination{};
+    socklen_t length;
+    if (address.protocol() == QAbstractSocket::IPv6Protocol) {
+        sockaddr_in6 *const in6 = reinterpret_cast<sockaddr_in6*>(&destination);
+        in6->sin6_family = AF_INET6;
+        in6->sin6_port = htons(port);
+        const Q_IPV6ADDR ipv6 = address.toIPv6Address();
+        (void) memcpy(&in6->sin6_addr, &ipv6, sizeof(in6->sin6_addr));
+        length = sizeof(sockaddr_in6);
+    } else {
+        sockaddr_in *const in = reinterpret_cast<sockaddr_in*>(&destination);
+        in->sin_family = AF_INET;
+        in->sin_port = htons(port);
+        in->sin_addr.s_addr = htonl(address.toIPv4Address());
+        length = sizeof(sockaddr_in);
+    }
+
+    _storage->destinations.push_back(destination);
+    _storage->destinationLengths.push_back(length);
+}
+
+int UDPSendBatch::destinationCount() const
+{
+    return static_cast<int>(_storage->destinations.size());
+}
+
+bool UDPSendBatch::append(const char *data, size_t length)
+{
+    if (isFull() || (length > maxFrameLength)) {
+        return false;
+    }
+
+    _storage->offsets[_frameCount] = _bytes;
+    _storage->lengths[_frameCount] = length;
+    (void) memcpy(_storage->frames + _bytes, data, length);
+    _bytes += length;
+    _frameCount++;
+    return true;
+}
+
+const char *UDPSendBatch::data() const
+{
+    return _storage->frames;
+}
+
+int UDPSendBatch::flush()
+{
+    if (isEmpty()) {
+        return 0;
+    }
+
+    Storage_t &s = *_storage;
+    const size_t destinationCount = s.destinations.size();
+
+    // Frames are stored back to back, so a run of equal length frames is one contiguous GSO buffer
+    struct Group_t { int first; int count; };
+    Group_t groups[maxFrames];
+    int groupCount = 0;
+    for (int i = 0; i < _frameCount; i++) {
+        if (_gsoEnabled && (groupCount > 0)) {
+            Group_t &last = groups[groupCount - 1];
+            if ((s.lengths[last.first] == s.lengths[i]) && (last.count < GSO_MAX_SEGMENTS)) {
+                last.count++;
+                continue;
+            }
+        }
+        groups[groupCount++] = { i, 1 };
+    }
+
+    const size_t messageCount = destinationCount * static_cast<size_t>(groupCount);
+    if (s.messages.size() < messageCount) {
+        s.messages.resize(messageCount);
+        s.iov.resize(messageCount);
+        s.control.resize(messageCount);
+    }
+
+    size_t message = 0;
+    for (size_t d = 0; d < destinationCount; d++) {
+        for (int g = 0; g < groupCount; g++) {
+            const Group_t &group = groups[g];
+            const size_t segmentLength = s.lengths[group.first];
+
+            iovec &iov = s.iov[message];
+            iov.iov_base = s.frames + s.offsets[group.first];
+            iov.iov_len = segmentLength * static_cast<size_t>(group.count);
+
+            mmsghdr &header = s.messages[message];
+            (void) memset(&header, 0, sizeof(header));
+            header.msg_hdr.msg_name = &s.destinations[d];
+            header.msg_hdr.msg_namelen = s.destinationLengths[d];
+            header.msg_hdr.msg_iov = &iov;
+            header.msg_hdr.msg_iovlen = 1;
+
+            if (group.count > 1) {
+                header.msg_hdr.msg_control = s.control[message].data;
+                header.msg_hdr.msg_controllen = sizeof(s.control[message].data);
+                cmsghdr *const cmsg = CMSG_FIRSTHDR(&header.msg_hdr);
+                cmsg->cmsg_level = SOL_UDP;
+                cmsg->cmsg_type = UDP_SEGMENT;
+                cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+                const uint16_t gsoSize = static_cast<uint16_t>(segmentLength);
+                (void) memcpy(CMSG_DATA(cmsg), &gsoSize, sizeof(gsoSize));
+            }
+
+            message++;
+        }
+    }
+
+    int failed = 0;
+    size_t sent = 0;
+    while (sent < messageCount) {
+        const int result = sendmmsg(_socketDescriptor, &s.messages[sent], static_cast<unsigned int>(messageCount - sent), 0);
+        if (result > 0) {
+            sent += static_cast<size_t>(result);
+            continue;
+        }
+        if (result == 0) {
+            break;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+
+        // The message at sent was refused, skip it and carry on with the other destinations
+        if ((errno == EIO) && s.messages[sent].msg_hdr.msg_controllen) {
+            // No checksum offload on the egress device, GSO can't be used on this socket. The refused
+            // group and the other groups of this flush still go out, one datagram per frame.
+            if (_gsoEnabled) {
+                qCWarning(UDPLinkLog) << "UDP GSO refused, sending one datagram per frame from now on";
+                _gsoEnabled = false;
+            }
+            failed += sendSegments(_socketDescriptor, s.messages[sent].msg_hdr);
+        } else {
+            qCWarning(UDPLinkLog) << "Could Not Send Data - Write Failed!" << strerror(errno);
+            failed++;
+        }
+        sent++;
+    }
+
+    _frameCount = 0;
+    _bytes = 0;
+    return failed;
+}
+
+#else
+
+struct UDPSendBatch::Storage_t {};
+
+UDPSendBatch::UDPSendBatch() {}
+UDPSendBatch::~UDPSendBatch() {}
+bool UDPSendBatch::isSupported() { return false; }
+void UDPSendBatch::setSocket(qintptr) {}
+void UDPSendBatch::clearDestinations() {}
+void UDPSendBatch::addDestination(const QHostAddress &, quint16) {}
+int UDPSendBatch::destinationCount() const { return 0; }
+bool UDPSendBatch::append(const char *, size_t) { return false; }
+const char *UDPSendBatch::data() const { return nullptr; }
+int UDPSendBatch::flush() { return 0; }
+
+#endif
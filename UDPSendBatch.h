@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QtCore/QtGlobal>
+#include <QtNetwork/QHostAddress>
+
+#include <memory>
+
+#include "MAVLinkLib.h"
+
+/// Collects outbound frames and sends every one of them to every destination with as few sendmmsg()
+/// calls as possible, instead of one writeDatagram() per frame per destination. Consecutive frames of
+/// equal length are handed to the kernel as one UDP GSO (UDP_SEGMENT) message per destination, which the
+/// kernel splits back into one datagram per frame. Linux only, isSupported() is false elsewhere.
+class UDPSendBatch
+{
+public:
+    UDPSendBatch();
+    ~UDPSendBatch();
+
+    UDPSendBatch(const UDPSendBatch&) = delete;
+    UDPSendBatch &operator=(const UDPSendBatch&) = delete;
+
+    static constexpr int maxFrames = 64;
+    static constexpr size_t maxFrameLength = MAVLINK_MAX_PACKET_LEN;
+
+    static bool isSupported();
+
+    /// Socket to send on, also probes it for UDP GSO support
+    void setSocket(qintptr socketDescriptor);
+    bool gsoEnabled() const { return _gsoEnabled; }
+
+    void clearDestinations();
+    void addDestination(const QHostAddress &address, quint16 port);
+    int destinationCount() const;
+
+    /// Copies the frame into the batch
+    ///     @return false: batch full or frame too long, nothing was added
+    bool append(const char *data, size_t length);
+    int frameCount() const { return _frameCount; }
+    bool isEmpty() const { return (_frameCount == 0); }
+    bool isFull() const { return (_frameCount == maxFrames); }
+    /// The frames appended since the last flush, back to back
+    const char *data() const;
+    size_t byteCount() const { return _bytes; }
+
+    /// Sends all frames to all destinations and empties the batch. A destination the kernel refuses is
+    /// skipped, the others are still served. A GSO message the kernel refuses is resent one datagram per frame.
+    ///     @return Number of messages the kernel refused
+    int flush();
+
+private:
+    struct Storage_t;
+    const std::unique_ptr<Storage_t> _storage;
+
+    int _socketDescriptor = -1;
+    bool _gsoEnabled = false;
+    int _frameCount = 0;
+    size_t _bytes = 0;
+};
@@ -0,0 +1,257 @@
+#include "UDPUringReceiver.h"
+#include "IoUring.h"
+
+#include <QtCore/QLoggingCategory>
+
+#ifdef QGC_IO_URING_AVAILABLE
+#include <netinet/in.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#endif
+
+Q_DECLARE_LOGGING_CATEGORY(UDPLinkLog)
+
+#ifdef QGC_IO_URING_AVAILABLE
+
+namespace {
+    // One receive request in flight, but room for a completion per buffer
+    constexpr unsigned RING_ENTRIES = 4;
+    constexpr unsigned COMPLETION_ENTRIES = 2 * UDPUringReceiver::bufferCount;
+    constexpr uint16_t BUFFER_GROUP = 0;
+}
+
+struct UDPUringReceiver::Rings_t
+{
+    IoUring ring;
+
+    io_uring_buf_ring *bufferRing = static_cast<io_uring_buf_ring*>(MAP_FAILED);
+    size_t bufferRingSize = 0;
+    char *buffers = static_cast<char*>(MAP_FAILED);
+
+    msghdr header{};
+    uint16_t bufferTail = 0;
+    sockaddr_storage lastSender{};
+    uint32_t lastSenderLength = 0;
+
+    void recycle(uint16_t bufferId)
+    {
+        // Not bufferRing->bufs: the flexible array helper of the uapi header shifts it by 8 bytes in C++
+        io_uring_buf &buffer = reinterpret_cast<io_uring_buf*>(bufferRing)[bufferTail & (bufferCount - 1)];
+        buffer.addr = reinterpret_cast<uintptr_t>(buffers + (static_cast<size_t>(bufferId) * bufferSize));
+        buffer.len = bufferSize;
+        buffer.bid = bufferId;
+        bufferTail++;
+    }
+
+    void publishBuffers()
+    {
+        reinterpret_cast<std::atomic<uint16_t>*>(&bufferRing->tail)->store(bufferTail, std::memory_order_release);
+    }
+};
+
+UDPUringReceiver::UDPUringReceiver()
+{
+}
+
+UDPUringReceiver::~UDPUringReceiver()
+{
+    close();
+}
+
+bool UDPUringReceiver::isSupported()
+{
+    return true;
+}
+
+bool UDPUringReceiver::open(qintptr socketDescriptor)
+{
+    close();
+
+    _rings = new Rings_t;
+    Rings_t &r = *_rings;
+
+    if (!r.ring.open(RING_ENTRIES, COMPLETION_ENTRIES)) {
+        qCDebug(UDPLinkLog) << "io_uring not available:" << strerror(errno);
+        close();
+        return false;
+    }
+
+    // Provided buffer ring: the kernel picks a free buffer per datagram, we hand it back after parsing
+    r.bufferRingSize = bufferCount * sizeof(io_uring_buf);
+    r.bufferRing = static_cast<io_uring_buf_ring*>(mmap(nullptr, r.bufferRingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    r.buffers = static_cast<char*>(mmap(nullptr, static_cast<size_t>(bufferCount) * bufferSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if ((r.bufferRing == MAP_FAILED) || (r.buffers == MAP_FAILED)) {
+        close();
+        return false;
+    }
+
+    io_uring_buf_reg registration{};
+    registration.ring_addr = reinterpret_cast<uintptr_t>(r.bufferRing);
+    registration.ring_entries = bufferCount;
+    registration.bgid = BUFFER_GROUP;
+    if (r.ring.registerResource(IORING_REGISTER_PBUF_RING, &registration, 1) < 0) {
+        qCDebug(UDPLinkLog) << "io_uring provided buffers not available:" << strerror(errno);
+        close();
+        return false;
+    }
+    for (uint16_t i = 0; i < bufferCount; i++) {
+        r.recycle(i);
+    }
+    r.publishBuffers();
+
+    // Only the header sizes matter for a multishot recvmsg, the kernel lays name and payload out in the buffer
+    r.header.msg_namelen = sizeof(sockaddr_storage);
+
+    _socketDescriptor = static_cast<int>(socketDescriptor);
+    if (!_arm()) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+bool UDPUringReceiver::isOpen() const
+{
+    return (_rings != nullptr);
+}
+
+int UDPUringReceiver::eventFd() const
+{
+    return _rings ? _rings->ring.eventFd() : -1;
+}
+
+void UDPUringReceiver::close()
+{
+    if (_rings) {
+        Rings_t &r = *_rings;
+        // Closing the ring cancels the armed receive
+        r.ring.close();
+        if (r.bufferRing != MAP_FAILED) {
+            (void) munmap(r.bufferRing, r.bufferRingSize);
+        }
+        if (r.buffers != MAP_FAILED) {
+            (void) munmap(r.buffers, static_cast<size_t>(bufferCount) * bufferSize);
+        }
+        delete _rings;
+        _rings = nullptr;
+    }
+    _socketDescriptor = -1;
+}
+
+bool UDPUringReceiver::_arm()
+{
+    Rings_t &r = *_rings;
+
+    io_uring_sqe *const sqe = r.ring.nextSqe();
+    if (!sqe) {
+        return false;
+    }
+    sqe->opcode = IORING_OP_RECVMSG;
+    sqe->fd = _socketDescriptor;
+    sqe->addr = reinterpret_cast<uintptr_t>(&r.header);
+    sqe->len = 1;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP;
+
+    return r.ring.submit();
+}
+
+int UDPUringReceiver::reap(const DatagramCallback &callback)
+{
+    if (!isOpen()) {
+        return -1;
+    }
+
+    Rings_t &r = *_rings;
+    int datagrams = 0;
+    bool rearm = false;
+    bool refused = false;
+
+    (void) r.ring.reap([this, &r, &callback, &datagrams, &rearm, &refused](const io_uring_cqe &cqe) {
+        if (!(cqe.flags & IORING_CQE_F_MORE)) {
+            rearm = true;
+        }
+
+        if (cqe.res < 0) {
+            if ((cqe.res == -EINVAL) || (cqe.res == -EOPNOTSUPP)) {
+                // Kernel older than multishot recvmsg
+                qCDebug(UDPLinkLog) << "io_uring multishot recvmsg refused:" << strerror(-cqe.res);
+                refused = true;
+                return false;
+            }
+            if (cqe.res != -ENOBUFS) {
+                qCWarning(UDPLinkLog) << "io_uring receive failed:" << strerror(-cqe.res);
+            }
+            return true;
+        }
+
+        if (!(cqe.flags & IORING_CQE_F_BUFFER)) {
+            return true;
+        }
+
+        const uint16_t bufferId = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+        const char *const buffer = r.buffers + (static_cast<size_t>(bufferId) * bufferSize);
+
+        // Buffer layout: io_uring_recvmsg_out, name (msg_namelen), control (msg_controllen), payload
+        io_uring_recvmsg_out out;
+        (void) memcpy(&out, buffer, sizeof(out));
+        const size_t payloadOffset = sizeof(out) + r.header.msg_namelen + r.header.msg_controllen;
+        const qint64 available = static_cast<qint64>(cqe.res) - static_cast<qint64>(payloadOffset);
+        const qint64 size = qMin<qint64>(out.payloadlen, qMax<qint64>(available, 0));
+        const bool truncated = (out.flags & MSG_TRUNC) || (size < static_cast<qint64>(out.payloadlen));
+
+        // Sender decoded only when it changed, a link mostly hears from one or two peers
+        const uint32_t senderLength = qMin<uint32_t>(out.namelen, r.header.msg_namelen);
+        const char *const sender = buffer + sizeof(out);
+        const bool newSender = (senderLength != r.lastSenderLength) || (memcmp(sender, &r.lastSender, senderLength) != 0);
+        if (newSender) {
+            (void) memcpy(&r.lastSender, sender, senderLength);
+            r.lastSenderLength = senderLength;
+            _cachedAddress.setAddress(reinterpret_cast<const sockaddr*>(&r.lastSender));
+            _cachedPort = (r.lastSender.ss_family == AF_INET6) ? ntohs(reinterpret_cast<const sockaddr_in6*>(&r.lastSender)->sin6_port)
+                                                               : ntohs(reinterpret_cast<const sockaddr_in*>(&r.lastSender)->sin_port);
+        }
+
+        callback(buffer + payloadOffset, size, _cachedAddress, _cachedPort, newSender, truncated);
+        datagrams++;
+
+        r.recycle(bufferId);
+        return true;
+    });
+    if (refused) {
+        close();
+        return -1;
+    }
+    r.publishBuffers();
+
+    // The kernel ends a multishot request when it ran out of buffers, arm it again now they are back
+    if (rearm && !_arm()) {
+        qCWarning(UDPLinkLog) << "io_uring receive could not be re-armed";
+        close();
+        return -1;
+    }
+
+    return datagrams;
+}
+
+#else
+
+struct UDPUringReceiver::Rings_t {};
+
+UDPUringReceiver::UDPUringReceiver() {}
+UDPUringReceiver::~UDPUringReceiver() {}
+bool UDPUringReceiver::isSupported() { return false; }
+bool UDPUringReceiver::isOpen() const { return false; }
+int UDPUringReceiver::eventFd() const { return -1; }
+bool UDPUringReceiver::open(qintptr) { return false; }
+void UDPUringReceiver::close() {}
+bool UDPUringReceiver::_arm() { return false; }
+int UDPUringReceiver::reap(const DatagramCallback &) { return -1; }
+
+#endif
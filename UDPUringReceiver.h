@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QtCore/QtGlobal>
+#include <QtNetwork/QHostAddress>
+
+#include <cstdint>
+#include <functional>
+
+/// io_uring receive engine for a UDP socket (Linux 6.0+). A single multishot recvmsg request stays armed
+/// on the socket and the kernel completes every datagram into a ring of buffers provided up front, so in
+/// steady state receiving costs no syscall per datagram: the owner waits on eventFd() and reap()s the
+/// completion ring, which is plain shared memory. Built without <linux/io_uring.h>, or where the kernel
+/// refuses the setup, open() fails and the caller keeps its QUdpSocket path.
+class UDPUringReceiver
+{
+public:
+    UDPUringReceiver();
+    ~UDPUringReceiver();
+
+    UDPUringReceiver(const UDPUringReceiver&) = delete;
+    UDPUringReceiver &operator=(const UDPUringReceiver&) = delete;
+
+    static constexpr int bufferCount = 64;        ///< Power of two
+    static constexpr int bufferSize = 4096;       ///< Includes the sender address, longer datagrams are truncated
+
+    static bool isSupported();
+
+    /// Sets up the ring, the buffers and the completion eventfd, and arms the receive on the socket
+    bool open(qintptr socketDescriptor);
+    void close();
+    bool isOpen() const;
+
+    /// Becomes readable when completions are waiting
+    int eventFd() const;
+
+    /// newSender is false while datagrams keep coming from the sender of the previous one
+    typedef std::function<void(const char *data, qint64 size, const QHostAddress &senderAddress, quint16 senderPort, bool newSender, bool truncated)> DatagramCallback;
+
+    /// Calls callback for every completed datagram and hands the buffers back to the kernel
+    ///     @return Number of datagrams, -1 when the kernel can't receive this way and the receiver closed itself
+    int reap(const DatagramCallback &callback);
+
+private:
+    bool _arm();
+
+    struct Rings_t;
+    Rings_t *_rings = nullptr;                  ///< Set while open
+    int _socketDescriptor = -1;
+    QHostAddress _cachedAddress;
+    quint16 _cachedPort = 0;
+};
@@ -0,0 +1,74 @@
+#include "WakeupNotifier.h"
+
+#include <QtCore/QSocketNotifier>
+
+#ifdef Q_OS_LINUX
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+WakeupNotifier::WakeupNotifier(std::function<bool()> hasPending, QObject *parent)
+    : QObject(parent)
+    , _hasPending(std::move(hasPending))
+{
+#ifdef Q_OS_LINUX
+    _eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (_eventFd >= 0) {
+        _notifier = new QSocketNotifier(_eventFd, QSocketNotifier::Read, this);
+        (void) connect(_notifier, &QSocketNotifier::activated, this, &WakeupNotifier::_onWakeup);
+    }
+#endif
+}
+
+WakeupNotifier::~WakeupNotifier()
+{
+#ifdef Q_OS_LINUX
+    if (_eventFd >= 0) {
+        delete _notifier;
+        (void) close(_eventFd);
+    }
+#endif
+}
+
+void WakeupNotifier::notify()
+{
+    if (_consumerIdle.exchange(false, std::memory_order_acq_rel)) {
+        _wake();
+    }
+}
+
+void WakeupNotifier::_wake()
+{
+    (void) _wakeupCount.fetch_add(1, std::memory_order_relaxed);
+
+#ifdef Q_OS_LINUX
+    if (_eventFd >= 0) {
+        const uint64_t one = 1;
+        (void) write(_eventFd, &one, sizeof(one));
+        return;
+    }
+#endif
+
+    (void) QMetaObject::invokeMethod(this, [this] {
+        _onWakeup();
+    }, Qt::QueuedConnection);
+}
+
+void WakeupNotifier::_onWakeup()
+{
+#ifdef Q_OS_LINUX
+    if (_eventFd >= 0) {
+        uint64_t count;
+        (void) read(_eventFd, &count, sizeof(count));
+    }
+#endif
+
+    emit activated();
+
+    // Go idle, then look again so an item pushed while we were still marked busy is not stranded
+    _consumerIdle.store(true, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_hasPending() && _consumerIdle.exchange(false, std::memory_order_acq_rel)) {
+        _wake();
+    }
+}
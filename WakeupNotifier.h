@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QtCore/QObject>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+class QSocketNotifier;
+
+/// Wakes the consumer of a lock-free queue from any producer thread. Only the notify() that finds the
+/// consumer idle pays for a wakeup (eventfd on Linux, a queued call elsewhere), so a burst of items costs
+/// a single one. activated() is emitted in the thread the object lives in; once its slots returned the
+/// consumer goes idle and hasPending() is asked again, so an item published during the drain is not stranded.
+class WakeupNotifier : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit WakeupNotifier(std::function<bool()> hasPending, QObject *parent = nullptr);
+    ~WakeupNotifier();
+
+    /// Any thread, after the item was published
+    void notify();
+
+    uint64_t wakeupCount() const { return _wakeupCount.load(std::memory_order_relaxed); }
+
+signals:
+    void activated();
+
+private:
+    void _wake();
+    void _onWakeup();
+
+    const std::function<bool()> _hasPending;
+    std::atomic<bool> _consumerIdle{true};
+    std::atomic<uint64_t> _wakeupCount{0};
+
+    int _eventFd = -1;
+    QSocketNotifier *_notifier = nullptr;
+};
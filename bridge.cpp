@@ -24,7 +24,7 @@ Bridge::Bridge(QObject *parent)
     _commLostCheckTimer(new QTimer(this)),
     _bridgeHearbeatTimer(new QTimer(this))
 {
-    connect(MAVLinkProtocol::instance(), &MAVLinkProtocol::messageReceived, this, &Bridge::mavlinkMessageReceived);
+    connect(MAVLinkProtocol::instance(), &MAVLinkProtocol::frameReceived, this, &Bridge::mavlinkFrameReceived);
     (void) connect(_commLostCheckTimer, &QTimer::timeout, this, &Bridge::_commLostCheck);
     (void) connect(_bridgeHearbeatTimer, &QTimer::timeout, this, &Bridge::_sendGCSHeartbeat);
 
@@ -64,12 +64,10 @@ void Bridge::addPixhawkSerialLink(LinkInterface* pixhawkSerialLink)
     _pixhawkSerialLink = pixhawkSerialLink;
 }
 
-void Bridge::mavlinkMessageReceived(LinkInterface *link, const mavlink_message_t &message)
+void Bridge::mavlinkFrameReceived(LinkInterface *link, const MAVLinkFrameView &frame)
 {
-    uint8_t buf[MAVLINK_MAX_PACKET_LEN]{};
-    const uint16_t len = mavlink_msg_to_send_buffer(buf, &message);
     // Radio status messages come from Sik Radios directly. It doesn't indicate there is any life on the other end.
-    if (message.msgid == MAVLINK_MSG_ID_RADIO_STATUS) {
+    if (frame.msgid() == MAVLINK_MSG_ID_RADIO_STATUS) {
         return;
     }
 
@@ -87,7 +85,6 @@ void Bridge::mavlinkMessageReceived(LinkInterface *link, const mavlink_message_t
             _updatePrimaryLink();
         }
     }
-    emit mavlinkToParse(message);
 }
 
 
@@ -165,11 +162,23 @@ void Bridge::_commLostCheck()
 
 void Bridge::_sendGCSHeartbeat()
 {
+    _sendHeartbeat(_primaryUdpLink);
+    _sendHeartbeat(_secondaryUdpLink);
+}
+
+void Bridge::_sendHeartbeat(LinkInterface *link)
+{
+    MAVLinkChannel *const channel = link ? link->mavlinkChannel() : nullptr;
+    if (!channel) {
+        return;
+    }
+
     mavlink_message_t message{};
-    (void) mavlink_msg_heartbeat_pack_chan(
+    QMutexLocker locker(channel->parser.signingMutex());
+    (void) mavlink_msg_heartbeat_pack_status(
         1,
         2,
-        _primaryUdpLink->mavlinkChannel(),
+        &channel->status,
         &message,
         MAV_TYPE_GENERIC,
         MAV_AUTOPILOT_INVALID,
@@ -178,23 +187,9 @@ void Bridge::_sendGCSHeartbeat()
         MAV_STATE_ACTIVE
         );
 
+    locker.unlock();
+
     uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
     const uint16_t len = mavlink_msg_to_send_buffer(buffer, &message);
-    (void) _primaryUdpLink->writeBytesThreadSafe(reinterpret_cast<const char*>(buffer), len);
-
-    (void) mavlink_msg_heartbeat_pack_chan(
-        1,
-        2,
-        _secondaryUdpLink->mavlinkChannel(),
-        &message,
-        MAV_TYPE_GENERIC,
-        MAV_AUTOPILOT_INVALID,
-        MAV_MODE_MANUAL_ARMED,
-        0,
-        MAV_STATE_ACTIVE
-        );
-
-    uint8_t buffer2[MAVLINK_MAX_PACKET_LEN];
-    const uint16_t len2 = mavlink_msg_to_send_buffer(buffer2, &message);
-    (void) _secondaryUdpLink->writeBytesThreadSafe(reinterpret_cast<const char*>(buffer2), len);
+    (void) link->writeBytesThreadSafe(reinterpret_cast<const char*>(buffer), len);
 }
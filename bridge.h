@@ -24,11 +24,8 @@ public:
     void addPixhawkSerialLink(LinkInterface* pixhawkSerialLink);
 
     WeakLinkInterfacePtr primaryLink() const { return _primaryLink; }
-signals:
-    void mavlinkToParse(const mavlink_message_t &message);
-
 protected slots:
-    void mavlinkMessageReceived(LinkInterface *link, const mavlink_message_t &message);
+    void mavlinkFrameReceived(LinkInterface *link, const MAVLinkFrameView &frame);
 
 
 
@@ -44,6 +41,7 @@ private:
     static constexpr int _heartbeatMaxElpasedMSecs = 3500;  ///< No heartbeat for longer than this indicates comm loss
 
     bool _updatePrimaryLink();
+    void _sendHeartbeat(LinkInterface *link);
 
     QTimer *_commLostCheckTimer = nullptr;
     QTimer *_bridgeHearbeatTimer = nullptr;
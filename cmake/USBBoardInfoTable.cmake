@@ -0,0 +1,163 @@
+# Turns USBBoardInfo.json into USBBoardInfoTable.h, the constexpr board table QGCSerialPortInfo searches
+# instead of parsing the json at runtime. Board classes, required keys and the version are checked here,
+# so a bad json fails the build rather than autoconnect.
+#
+#   cmake -DINPUT=USBBoardInfo.json -DOUTPUT=USBBoardInfoTable.h -P USBBoardInfoTable.cmake
+
+cmake_minimum_required(VERSION 3.19)
+
+file(READ "${INPUT}" json)
+
+string(JSON fileType GET "${json}" fileType)
+string(JSON version GET "${json}" version)
+if(NOT fileType STREQUAL "USBBoardInfo" OR NOT version EQUAL 1)
+    message(FATAL_ERROR "${INPUT}: expected USBBoardInfo version 1, got ${fileType} version ${version}")
+endif()
+
+function(board_type boardClass out)
+    if(boardClass STREQUAL "Pixhawk")
+        set(type BoardTypePixhawk)
+    elseif(boardClass STREQUAL "SiK Radio")
+        set(type BoardTypeSiKRadio)
+    elseif(boardClass STREQUAL "OpenPilot")
+        set(type BoardTypeOpenPilot)
+    elseif(boardClass STREQUAL "RTK GPS")
+        set(type BoardTypeRTKGPS)
+    else()
+        message(FATAL_ERROR "${INPUT}: bad board class '${boardClass}'")
+    endif()
+    set(${out} "QGCSerialPortInfo::${type}" PARENT_SCOPE)
+endfunction()
+
+# Zero padded so the list sorts numerically
+function(pad value width out)
+    string(LENGTH "${value}" length)
+    while(length LESS width)
+        string(PREPEND value "0")
+        math(EXPR length "${length} + 1")
+    endwhile()
+    set(${out} "${value}" PARENT_SCOPE)
+endfunction()
+
+function(check_text text)
+    if(text MATCHES ";" OR text MATCHES "\\)usb\"")
+        message(FATAL_ERROR "${INPUT}: unsupported characters in '${text}'")
+    endif()
+endfunction()
+
+# Boards, sorted by key then json order
+string(JSON boardCount LENGTH "${json}" boardInfo)
+set(sortedBoards "")
+if(boardCount GREATER 0)
+    math(EXPR last "${boardCount} - 1")
+    foreach(i RANGE ${last})
+        string(JSON vendorId GET "${json}" boardInfo ${i} vendorID)
+        string(JSON productId GET "${json}" boardInfo ${i} productID)
+        string(JSON boardClass GET "${json}" boardInfo ${i} boardClass)
+        string(JSON name GET "${json}" boardInfo ${i} name)
+        if(vendorId LESS 0 OR vendorId GREATER 65535 OR productId LESS 0 OR productId GREATER 65535)
+            message(FATAL_ERROR "${INPUT}: bad vendorID/productID ${vendorId}/${productId} for '${name}'")
+        endif()
+        check_text("${name}")
+        board_type("${boardClass}" type)
+
+        math(EXPR key "(${vendorId} << 16) | ${productId}")
+        math(EXPR hexKey "${key}" OUTPUT_FORMAT HEXADECIMAL)
+        pad(${key} 10 sortKey)
+        pad(${i} 5 sortOrder)
+        list(APPEND sortedBoards "${sortKey}|${sortOrder}|    { ${hexKey}u, ${i}, ${type}, R\"usb(${name})usb\" },")
+    endforeach()
+endif()
+list(SORT sortedBoards)
+
+set(boardLines "")
+set(previousKey "")
+foreach(entry IN LISTS sortedBoards)
+    string(REGEX MATCH "^([0-9]+)\\|[0-9]+\\|(.*)$" unused "${entry}")
+    # Only the first entry of a key can ever match
+    if(NOT CMAKE_MATCH_1 STREQUAL previousKey)
+        string(APPEND boardLines "${CMAKE_MATCH_2}\n")
+        set(previousKey "${CMAKE_MATCH_1}")
+    endif()
+endforeach()
+
+function(fallback_lines arrayKey out)
+    set(lines "")
+    string(JSON count LENGTH "${json}" ${arrayKey})
+    if(count GREATER 0)
+        math(EXPR last "${count} - 1")
+        foreach(i RANGE ${last})
+            string(JSON regExp GET "${json}" ${arrayKey} ${i} regExp)
+            string(JSON boardClass GET "${json}" ${arrayKey} ${i} boardClass)
+            string(JSON androidOnly ERROR_VARIABLE noAndroidOnly GET "${json}" ${arrayKey} ${i} androidOnly)
+            if(noAndroidOnly OR NOT androidOnly)
+                set(androidOnly false)
+            else()
+                set(androidOnly true)
+            endif()
+            if(regExp STREQUAL "")
+                message(FATAL_ERROR "${INPUT}: empty regExp in ${arrayKey}")
+            endif()
+            check_text("${regExp}")
+            board_type("${boardClass}" type)
+            string(APPEND lines "    { R\"usb(${regExp})usb\", ${type}, ${androidOnly} },\n")
+        endforeach()
+    endif()
+    set(${out} "${lines}" PARENT_SCOPE)
+endfunction()
+
+fallback_lines(boardDescriptionFallback descriptionLines)
+fallback_lines(boardManufacturerFallback manufacturerLines)
+
+set(content "// Generated from USBBoardInfo.json by cmake/USBBoardInfoTable.cmake, do not edit
+
+#pragma once
+
+#include \"QGCSerialPortInfo.h\"
+
+#include <cstddef>
+
+namespace USBBoardInfoTable {
+
+struct Board_t {
+    quint32 key;                            ///< vendorId << 16 | productId, productId 0: any product
+    int order;                              ///< Position in the json, of an exact and an any product match the earlier wins
+    QGCSerialPortInfo::BoardType_t boardType;
+    const char *name;
+};
+
+struct Fallback_t {
+    const char *regExp;                     ///< nullptr ends the list
+    QGCSerialPortInfo::BoardType_t boardType;
+    bool androidOnly;
+};
+
+/// Sorted by key, one entry per key
+constexpr Board_t boards[] = {
+${boardLines}    { 0xffffffffu, -1, QGCSerialPortInfo::BoardTypeUnknown, nullptr }
+};
+constexpr size_t boardCount = (sizeof(boards) / sizeof(boards[0])) - 1;
+
+constexpr bool isSorted()
+{
+    for (size_t i = 1; i < boardCount; i++) {
+        if (boards[i - 1].key >= boards[i].key) {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(isSorted(), \"USBBoardInfoTable::boards must be sorted by key\");
+
+constexpr Fallback_t descriptionFallbacks[] = {
+${descriptionLines}    { nullptr, QGCSerialPortInfo::BoardTypeUnknown, false }
+};
+
+constexpr Fallback_t manufacturerFallbacks[] = {
+${manufacturerLines}    { nullptr, QGCSerialPortInfo::BoardTypeUnknown, false }
+};
+
+} // namespace USBBoardInfoTable
+")
+
+file(WRITE "${OUTPUT}" "${content}")
@@ -2,6 +2,8 @@
 #include "SerialLink.h"
 #include "UDPLink.h"
 
+#include <QtCore/QCryptographicHash>
+
 
 LinkConfiguration::LinkConfiguration(const QString &name, QObject *parent)
     : QObject(parent)
@@ -16,6 +18,7 @@ LinkConfiguration::LinkConfiguration(const LinkConfiguration *copy, QObject *par
     , _dynamic(copy->isDynamic())
     , _autoConnect(copy->isAutoConnect())
     , _highLatency(copy->isHighLatency())
+    , _signingKey(copy->signingKey())
 {
 
     Q_ASSERT(!_name.isEmpty());
@@ -34,6 +37,7 @@ void LinkConfiguration::copyFrom(const LinkConfiguration *source)
     setDynamic(source->isDynamic());
     setAutoConnect(source->isAutoConnect());
     setHighLatency(source->isHighLatency());
+    setSigningKey(source->signingKey());
 }
 
 LinkConfiguration *LinkConfiguration::createSettings(int type, const QString &name)
@@ -120,3 +124,20 @@ void LinkConfiguration::setHighLatency(bool hl)
         emit highLatencyChanged();
     }
 }
+
+void LinkConfiguration::setSigningKey(const QString &signingKey)
+{
+    if (signingKey != _signingKey) {
+        _signingKey = signingKey;
+        emit signingKeyChanged();
+    }
+}
+
+QByteArray LinkConfiguration::signingKeyBytes() const
+{
+    if (_signingKey.isEmpty()) {
+        return QByteArray();
+    }
+
+    return QCryptographicHash::hash(_signingKey.toUtf8(), QCryptographicHash::Sha256);
+}
@@ -23,6 +23,7 @@ class LinkConfiguration : public QObject
     Q_PROPERTY(QString          settingsURL     READ settingsURL                            CONSTANT)
     Q_PROPERTY(QString          settingsTitle   READ settingsTitle                          CONSTANT)
     Q_PROPERTY(bool             highLatency     READ isHighLatency  WRITE setHighLatency    NOTIFY highLatencyChanged)
+    Q_PROPERTY(QString          signingKey      READ signingKey     WRITE setSigningKey     NOTIFY signingKeyChanged)
 
 public:
     LinkConfiguration(const QString &name, QObject *parent = nullptr);
@@ -61,6 +62,13 @@ public:
     /// Set if this is this an High Latency configuration.
     void setHighLatency(bool hl = false);
 
+    /// MAVLink 2 signing passphrase for this link, empty for no signing
+    QString signingKey() const { return _signingKey; }
+    void setSigningKey(const QString &signingKey);
+
+    /// 32 byte secret key derived from signingKey(), empty if signing is off
+    QByteArray signingKeyBytes() const;
+
     /// Copy instance data, When manipulating data, you create a copy of the configuration using the copy constructor,
     /// edit it and then transfer its content to the original using this method.
     ///     @param[in] source The source instance (the edited copy)
@@ -113,6 +121,7 @@ signals:
     void dynamicChanged();
     void autoConnectChanged();
     void highLatencyChanged();
+    void signingKeyChanged();
 
 protected:
     std::weak_ptr<LinkInterface> _link; ///< Link currently using this configuration (if any)
@@ -123,6 +132,7 @@ private:
     bool _forwarding = false;  ///< Automatically added Mavlink forwarding connection
     bool _autoConnect = false; ///< This connection is started automatically at boot
     bool _highLatency = false;
+    QString _signingKey;
 };
 
 typedef std::shared_ptr<LinkConfiguration> SharedLinkConfigurationPtr;
@@ -1,12 +1,17 @@
 #include "linkinterface.h"
 #include "linkmanager.h"
+#include "mavlinkprotocol.h"
 #include <QDebug>
+#include <QDateTime>
 #include <QTimer>
 LinkInterface::LinkInterface(SharedLinkConfigurationPtr &config, QObject *parent)
     : QObject{parent}
     , _config(config)
+    , _rxRing(new MAVLinkFrameRing(_rxRingSlots, this))
+    , _rxFrames(_rxRing->capacity())
 {
-
+    (void) connect(_rxRing, &MAVLinkFrameRing::readyRead, this, &LinkInterface::_drainRxRing);
+    (void) connect(_config.get(), &LinkConfiguration::signingKeyChanged, this, &LinkInterface::initMavlinkSigning);
 }
 
 LinkInterface::~LinkInterface()
@@ -14,7 +19,7 @@ LinkInterface::~LinkInterface()
 
 }
 
-uint8_t LinkInterface::mavlinkChannel() const
+MAVLinkChannel *LinkInterface::mavlinkChannel() const
 {
     if(!mavlinkChannelIsSet()){
         qDebug()<<"mavlink channel not set";
@@ -24,7 +29,7 @@ uint8_t LinkInterface::mavlinkChannel() const
 
 bool LinkInterface::mavlinkChannelIsSet() const
 {
-    return (LinkManager::invalidMavlinkChannel() != _mavlinkChannel);
+    return (_mavlinkChannel != nullptr);
 }
 
 bool LinkInterface::_allocateMavlinkChannel()
@@ -32,7 +37,7 @@ bool LinkInterface::_allocateMavlinkChannel()
     Q_ASSERT(!mavlinkChannelIsSet());
 
     if (mavlinkChannelIsSet()) {
-        qDebug() << "already have" << _mavlinkChannel;
+        qDebug() << "already have" << _mavlinkChannel->id;
         return true;
     }
 
@@ -43,7 +48,7 @@ bool LinkInterface::_allocateMavlinkChannel()
         return false;
     }
 
-    qDebug() << "_allocateMavlinkChannel" << _mavlinkChannel;
+    qDebug() << "_allocateMavlinkChannel" << _mavlinkChannel->id;
 
 
     return true;
@@ -51,21 +56,131 @@ bool LinkInterface::_allocateMavlinkChannel()
 
 void LinkInterface::_freeMavlinkChannel()
 {
-    qDebug() << _mavlinkChannel;
-
     if (!mavlinkChannelIsSet()) {
         return;
     }
 
+    qDebug() << _mavlinkChannel->id;
+
+    _releaseSigningLinkId();
     LinkManager::instance()->freeMavlinkChannel(_mavlinkChannel);
-    _mavlinkChannel = LinkManager::invalidMavlinkChannel();
+    _mavlinkChannel = nullptr;
+}
+
+void LinkInterface::initMavlinkSigning()
+{
+    if (!mavlinkChannelIsSet()) {
+        return;
+    }
+
+    mavlink_status_t *const status = &_mavlinkChannel->status;
+    const QByteArray key = _config->signingKeyBytes();
+
+    QMutexLocker locker(&_signingMutex);
+    _mavlinkChannel->parser.setSigningMutex(&_signingMutex);
+    if (key.size() != sizeof(_signing.secret_key)) {
+        status->signing = nullptr;
+        status->signing_streams = nullptr;
+        _releaseSigningLinkId();
+        return;
+    }
+
+    if (_signingLinkId < 0) {
+        _signingLinkId = MAVLinkChannelPool::instance()->allocateSigningLinkId();
+        if (_signingLinkId < 0) {
+            qWarning() << "Signing not enabled on" << _config->name() << "- all" << MAVLinkChannelPool::maxSigningLinkIds << "signing link ids in use";
+            status->signing = nullptr;
+            status->signing_streams = nullptr;
+            return;
+        }
+    }
+
+    // MAVLink signing timestamps are in 10 microsecond units since 1 January 2015 GMT
+    static constexpr qint64 signingEpochMSecs = 1420070400000;
+
+    _signing = {};
+    (void) memcpy(_signing.secret_key, key.constData(), sizeof(_signing.secret_key));
+    _signing.link_id = static_cast<uint8_t>(_signingLinkId);
+    _signing.flags = MAVLINK_SIGNING_FLAG_SIGN_OUTGOING;
+    _signing.timestamp = static_cast<uint64_t>(QDateTime::currentMSecsSinceEpoch() - signingEpochMSecs) * 100;
+    _signing.accept_unsigned_callback = isSecureConnection() ? _secureConnectionAcceptUnsigned : _insecureConnectionAcceptUnsigned;
+
+    // Replay history of the old key is meaningless for the new one
+    _signingStreams = {};
+
+    status->signing = &_signing;
+    status->signing_streams = &_signingStreams;
+}
+
+void LinkInterface::_releaseSigningLinkId()
+{
+    if (_signingLinkId < 0) {
+        return;
+    }
+
+    MAVLinkChannelPool::instance()->releaseSigningLinkId(_signingLinkId);
+    _signingLinkId = -1;
+}
+
+bool LinkInterface::_secureConnectionAcceptUnsigned(const mavlink_status_t *status, uint32_t msgid)
+{
+    Q_UNUSED(status); Q_UNUSED(msgid);
+
+    // Nobody can inject on a secure connection, so unsigned traffic is fine
+    return true;
+}
+
+bool LinkInterface::_insecureConnectionAcceptUnsigned(const mavlink_status_t *status, uint32_t msgid)
+{
+    Q_UNUSED(status);
+
+    // Radio status comes unsigned from the local SiK radio itself
+    return (msgid == MAVLINK_MSG_ID_RADIO_STATUS);
+}
+
+void LinkInterface::_drainRxRing()
+{
+    // The views borrow the ring slots, which only go back to the worker once the router is done with them
+    const auto aim = [this](size_t index, const uint8_t *frame, size_t frameLength) {
+        _rxFrames[index].setRawFrame(frame, frameLength);
+    };
+    const auto route = [this](size_t count) {
+        emit framesReceived(this, _rxFrames.data(), static_cast<int>(count));
+    };
+    while (_rxRing->drainBatch(aim, route) > 0) {}
 }
 
 void LinkInterface::writeBytesThreadSafe(const char *bytes, int length)
 {
-    const QByteArray data(bytes, length);
+    writeBytesThreadSafe(QByteArray::fromRawData(bytes, length));
+}
 
-    (void) QMetaObject::invokeMethod(this, [this, data] {
-        _writeBytes(data);
+void LinkInterface::writeBytesThreadSafe(const QByteArray &data)
+{
+    if (_queueWrite(data.constData(), data.size())) {
+        return;
+    }
+
+    // data may borrow memory that is gone by the time the queued write runs, such as a received frame view
+    const QByteArray bytes(data.constData(), data.size());
+    (void) QMetaObject::invokeMethod(this, [this, bytes] {
+        _writeBytes(bytes);
     }, Qt::AutoConnection);
 }
+
+bool LinkInterface::_queueWrite(const char *bytes, int length)
+{
+    MAVLinkTxQueue *const txQueue = this->txQueue();
+    if (!txQueue || (static_cast<size_t>(length) > MAVLinkTxQueue::maxFrameLength)) {
+        return false;
+    }
+
+    if (txQueue->push(bytes, static_cast<size_t>(length))) {
+        return true;
+    }
+
+    // A disconnected link hands the frame to _writeBytes(), which reports the error. A full queue drops it
+    // and counts it in overflowCount(), like SerialTxQueue on overflow: any other way out would let it
+    // overtake the frames still queued.
+    return txQueue->isOpen();
+}
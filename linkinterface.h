@@ -2,8 +2,13 @@
 #define LINKINTERFACE_H
 
 #include "linkconfiguration.h"
+#include "MAVLinkChannel.h"
+#include "MAVLinkFrameRing.h"
+#include "MAVLinkTxQueue.h"
 #include <QObject>
+#include <atomic>
 #include <memory>
+#include <vector>
 class LinkManager;
 
 class LinkInterface : public QObject
@@ -22,13 +27,35 @@ public:
 
     SharedLinkConfigurationPtr linkConfiguration() { return _config; }
     const SharedLinkConfigurationPtr linkConfiguration() const { return _config; }
-    uint8_t mavlinkChannel() const;
+    /// Parse and signing state of the link, nullptr while no channel is allocated
+    MAVLinkChannel *mavlinkChannel() const;
     bool mavlinkChannelIsSet() const;
 
+    /// (Re)applies the signing key of the link configuration to the mavlink channel.
+    /// Signing is turned off when the configuration has no key.
+    virtual void initMavlinkSigning();
 
+
+    /// Frames framed on the worker thread wait here for the router, see MAVLinkProtocol::workerFraming()
+    MAVLinkFrameRing *rxRing() const { return _rxRing; }
+
+    /// Outbound queue drained by the link worker, nullptr if the link has none
+    MAVLinkTxQueue *txQueue() const { return _txQueue.load(std::memory_order_acquire); }
+
+    /// Any thread. Up to MAVLinkTxQueue::maxFrameLength bytes are copied straight into txQueue() without
+    /// allocating. A full queue drops the frame and counts it, so frames never overtake each other.
+    /// Longer writes, and writes while the link is not connected, take the queued _writeBytes() path on a
+    /// copy. The worker sends what the queue holds by then first.
     void writeBytesThreadSafe(const char *bytes, int length);
+    void writeBytesThreadSafe(const QByteArray &data);
 signals:
     void bytesReceived(LinkInterface* link, const QByteArray &data);
+    /// Emitted instead of bytesReceived by links multiplexing several remote streams. channel holds the
+    /// parse state of the sender and is only valid during the emission, connect with Qt::DirectConnection.
+    void channelBytesReceived(LinkInterface* link, MAVLinkChannel *channel, const QByteArray &data);
+    /// Emitted instead of bytesReceived when the link worker already did the framing, once per drain of rxRing().
+    /// The views borrow the ring slots and are only valid during the emission, connect with Qt::DirectConnection.
+    void framesReceived(LinkInterface* link, const MAVLinkFrameView *frames, int count);
     void bytesSent(LinkInterface *link, const QByteArray &data);
     void connected();
     void disconnected();
@@ -38,14 +65,36 @@ protected:
 
     virtual void _freeMavlinkChannel();
     bool _allocateMavlinkChannel();
+    /// Called by links whose worker drains an outbound queue, nullptr before the queue goes away
+    void _setTxQueue(MAVLinkTxQueue *txQueue) { _txQueue.store(txQueue, std::memory_order_release); }
     SharedLinkConfigurationPtr _config;
 private slots:
     /// Not thread safe if called directly, only writeBytesThreadSafe is thread safe
     virtual void _writeBytes(const QByteArray &bytes) = 0;
+    void _drainRxRing();
 private:
     virtual bool _connect() = 0;
+    /// @return false: the write has to take the _writeBytes() path, true: queued or dropped
+    bool _queueWrite(const char *bytes, int length);
+    /// Hands the signing link id back, so a later link can sign with it
+    void _releaseSigningLinkId();
+
+    static bool _secureConnectionAcceptUnsigned(const mavlink_status_t *status, uint32_t msgid);
+    static bool _insecureConnectionAcceptUnsigned(const mavlink_status_t *status, uint32_t msgid);
+
+    MAVLinkChannel *_mavlinkChannel = nullptr;
+    MAVLinkFrameRing *_rxRing = nullptr;
+    std::vector<MAVLinkFrameView> _rxFrames;    ///< One view per ring slot, re-aimed at every drain
+    std::atomic<MAVLinkTxQueue*> _txQueue{nullptr};
+
+    static constexpr size_t _rxRingSlots = 256;
 
-    uint8_t _mavlinkChannel = std::numeric_limits<uint8_t>::max();
+    /// Signing state of this link only, so the signature checks of different links run in parallel.
+    /// A stream seen on two links, such as a vehicle on redundant links, is replay checked on each.
+    QMutex _signingMutex;
+    mavlink_signing_t _signing{};
+    mavlink_signing_streams_t _signingStreams{};
+    int _signingLinkId = -1;    ///< From MAVLinkChannelPool::allocateSigningLinkId(), -1 while unsigned
 };
 
 typedef std::shared_ptr<LinkInterface> SharedLinkInterfacePtr;
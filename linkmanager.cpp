@@ -12,6 +12,8 @@
 
 #include "UDPLink.h"
 #include "SerialLink.h"
+#include "SerialHotplugMonitor.h"
+#include "SerialAutoConnectProbe.h"
 #include "UdpIODevice.h"
 #include "bridge.h"
 
@@ -58,6 +60,34 @@ void LinkManager::init()
 
     (void) connect(_portListTimer, &QTimer::timeout, this, &LinkManager::_updateAutoConnectLinks);
     _portListTimer->start(_autoconnectUpdateTimerMSecs); // timeout must be long enough to get past bootloader on second pass
+
+#ifndef QGC_NO_SERIAL_LINK
+    _autoconnectClock.start();
+
+    _serialScanTimer = new QTimer(this);
+    _serialScanTimer->setSingleShot(true);
+    (void) connect(_serialScanTimer, &QTimer::timeout, this, [this] {
+        if (!_connectionsSuspended) {
+            _addSerialAutoConnectLink();
+        }
+    });
+
+    SerialHotplugMonitor *const hotplug = SerialHotplugMonitor::instance();
+    _serialHotplug = hotplug->isActive();
+    if (_serialHotplug) {
+        QGCSerialPortInfo::setPortChangesNotified(true);
+
+        (void) connect(hotplug, &SerialHotplugMonitor::serialPortAdded, this, &LinkManager::_onSerialPortAdded);
+        (void) connect(hotplug, &SerialHotplugMonitor::serialPortRemoved, this, &LinkManager::_onSerialPortRemoved);
+        (void) connect(hotplug, &SerialHotplugMonitor::rescanNeeded, this, [this] {
+            QGCSerialPortInfo::invalidatePorts();
+            _scheduleSerialScan(_hotplugSettleMSecs);
+        });
+
+        // Ports plugged in before we started
+        _scheduleSerialScan(0);
+    }
+#endif
     Bridge::instance()->init();
 
 }
@@ -102,12 +132,15 @@ bool LinkManager::createConnectedLink(SharedLinkConfigurationPtr &config)
         qCWarning(LinkManagerLog) << "Link failed to setup mavlink channels";
         return false;
     }
+    link->initMavlinkSigning();
 
     _rgLinks.append(link);
     config->setLink(link);
 
     (void) connect(link.get(), &LinkInterface::communicationError, this, &LinkManager::_communicationError);
     (void) connect(link.get(), &LinkInterface::bytesReceived, MAVLinkProtocol::instance(), &MAVLinkProtocol::receiveBytes);
+    (void) connect(link.get(), &LinkInterface::channelBytesReceived, MAVLinkProtocol::instance(), &MAVLinkProtocol::receiveChannelBytes, Qt::DirectConnection);
+    (void) connect(link.get(), &LinkInterface::framesReceived, MAVLinkProtocol::instance(), &MAVLinkProtocol::receiveFrames, Qt::DirectConnection);
     (void) connect(link.get(), &LinkInterface::disconnected, this, &LinkManager::_linkDisconnected);
 
     MAVLinkProtocol::instance()->resetMetadataForLink(link.get());
@@ -216,9 +249,13 @@ void LinkManager::_linkDisconnected()
     }
 
     (void) disconnect(link, &LinkInterface::bytesReceived, MAVLinkProtocol::instance(), &MAVLinkProtocol::receiveBytes);
+    (void) disconnect(link, &LinkInterface::channelBytesReceived, MAVLinkProtocol::instance(), &MAVLinkProtocol::receiveChannelBytes);
+    (void) disconnect(link, &LinkInterface::framesReceived, MAVLinkProtocol::instance(), &MAVLinkProtocol::receiveFrames);
     //(void) disconnect(link, &LinkInterface::bytesSent, MAVLinkProtocol::instance(), &MAVLinkProtocol::logSentBytes);
     (void) disconnect(link, &LinkInterface::disconnected, this, &LinkManager::_linkDisconnected);
 
+    // Drops its routes too
+    MAVLinkProtocol::instance()->resetMetadataForLink(link);
     link->_freeMavlinkChannel();
 
     for (auto it = _rgLinks.begin(); it != _rgLinks.end(); ++it) {
@@ -274,6 +311,7 @@ void LinkManager::saveLinkConfigurationList()
         settings.setValue(root + "/type", linkConfig->type());
         settings.setValue(root + "/auto", linkConfig->isAutoConnect());
         settings.setValue(root + "/high_latency", linkConfig->isHighLatency());
+        settings.setValue(root + "/signing_key", linkConfig->signingKey());
         linkConfig->saveSettings(settings, root);
     }
 
@@ -330,6 +368,7 @@ void LinkManager::loadLinkConfigurationList()
                 link->setAutoConnect(autoConnect);
                 const bool highLatency = settings.value(root + "/high_latency").toBool();
                 link->setHighLatency(highLatency);
+                link->setSigningKey(settings.value(root + "/signing_key").toString());
                 link->loadSettings(settings, root);
                 addConfiguration(link);
             }
@@ -411,7 +450,10 @@ void LinkManager::_updateAutoConnectLinks()
 
 
 #ifndef QGC_NO_SERIAL_LINK
-    _addSerialAutoConnectLink();
+    // Without hotplug events the serial ports are polled here
+    if (!_serialHotplug) {
+        _addSerialAutoConnectLink();
+    }
 #endif
 
 }
@@ -564,34 +606,21 @@ void LinkManager::startAutoConnectedLinks()
     }
 }
 
-uint8_t LinkManager::allocateMavlinkChannel()
+MAVLinkChannel *LinkManager::allocateMavlinkChannel()
 {
-    for (uint8_t mavlinkChannel = 0; mavlinkChannel < MAVLINK_COMM_NUM_BUFFERS; mavlinkChannel++) {
-        if (_mavlinkChannelsUsedBitMask & (1 << mavlinkChannel)) {
-            continue;
-        }
-
-        mavlink_reset_channel_status(mavlinkChannel);
-        mavlink_status_t* const mavlinkStatus = mavlink_get_channel_status(mavlinkChannel);
-        mavlinkStatus->flags |= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
-        _mavlinkChannelsUsedBitMask |= (1 << mavlinkChannel);
-        qCDebug(LinkManagerLog) << "allocateMavlinkChannel" << mavlinkChannel;
-        return mavlinkChannel;
-    }
-
-    qWarning(LinkManagerLog) << "allocateMavlinkChannel: all channels reserved!";
-    return invalidMavlinkChannel();
+    MAVLinkChannel *const channel = MAVLinkChannelPool::instance()->allocate();
+    qCDebug(LinkManagerLog) << "allocateMavlinkChannel" << channel->id;
+    return channel;
 }
 
-void LinkManager::freeMavlinkChannel(uint8_t channel)
+void LinkManager::freeMavlinkChannel(MAVLinkChannel *channel)
 {
-    qCDebug(LinkManagerLog) << "freeMavlinkChannel" << channel;
-
-    if (invalidMavlinkChannel() == channel) {
+    if (!channel) {
         return;
     }
 
-    _mavlinkChannelsUsedBitMask &= ~(1 << channel);
+    qCDebug(LinkManagerLog) << "freeMavlinkChannel" << channel->id;
+    MAVLinkChannelPool::instance()->release(channel);
 }
 
 
@@ -635,7 +664,7 @@ bool LinkManager::isLinkUSBDirect(const LinkInterface *link)
 void LinkManager::resetMavlinkSigning()
 {
     for (const SharedLinkInterfacePtr &sharedLink: _rgLinks) {
-        //sharedLink->initMavlinkSigning();
+        sharedLink->initMavlinkSigning();
     }
 }
 
@@ -714,15 +743,14 @@ void LinkManager::_addSerialAutoConnectLink()
             }
             if (_portAlreadyConnected(portInfo.systemLocation()) || (_autoConnectRTKPort == portInfo.systemLocation())) {
                 //qCDebug(LinkManagerVerboseLog) << "Skipping existing autoconnect" << portInfo.systemLocation();
-            } else if (!_autoconnectPortWaitList.contains(portInfo.systemLocation())) {
-                // We don't connect to the port the first time we see it. The ability to correctly detect whether we
-                // are in the bootloader is flaky from a cross-platform standpoint. So by putting it on a wait list
-                // and only connect on the second pass we leave enough time for the board to boot up.
-                qCDebug(LinkManagerLog) << "Waiting for next autoconnect pass" << portInfo.systemLocation() << boardName;
-                _autoconnectPortWaitList[portInfo.systemLocation()] = 1;
-            } else if ((++_autoconnectPortWaitList[portInfo.systemLocation()] * _autoconnectUpdateTimerMSecs) > _autoconnectConnectDelayMSecs) {
+            } else if ((boardType == QGCSerialPortInfo::BoardTypePixhawk) && _autoconnectProbing(portInfo.systemLocation(), 115200)) {
+                // No heartbeat yet, see _autoconnectProbing()
+            } else if ((boardType != QGCSerialPortInfo::BoardTypePixhawk) && (_autoconnectWaitMSecs(portInfo.systemLocation()) > 0)) {
+                // Still booting, see _autoconnectWaitMSecs()
+            } else {
                 SerialConfiguration* pSerialConfig = nullptr;
                 _autoconnectPortWaitList.remove(portInfo.systemLocation());
+                _recentlyRemovedPorts.remove(portInfo.systemLocation());
                 switch (boardType) {
                 case QGCSerialPortInfo::BoardTypePixhawk:
                     pSerialConfig = new SerialConfiguration(tr("%1 on %2 (AutoConnect)").arg(boardName, portInfo.portName().trimmed()));
@@ -759,6 +787,16 @@ void LinkManager::_addSerialAutoConnectLink()
         }
     }
 
+    // Probes of ports which went away without a hotplug event
+    for (auto it = _autoconnectProbes.begin(); it != _autoconnectProbes.end();) {
+        if (currentPorts.contains(it.key())) {
+            ++it;
+        } else {
+            delete it.value();
+            it = _autoconnectProbes.erase(it);
+        }
+    }
+
     // Check for RTK GPS connection gone
     if (!_autoConnectRTKPort.isEmpty() && !currentPorts.contains(_autoConnectRTKPort)) {
         qCDebug(LinkManagerLog) << "RTK GPS disconnected" << _autoConnectRTKPort;
@@ -767,6 +805,114 @@ void LinkManager::_addSerialAutoConnectLink()
     }
 }
 
+bool LinkManager::_autoconnectProbing(const QString &systemLocation, qint32 baud)
+{
+    // A connected port that dropped off the bus a moment ago is back from a USB glitch, not booting
+    const auto removed = _recentlyRemovedPorts.constFind(systemLocation);
+    if ((removed != _recentlyRemovedPorts.constEnd()) && ((_autoconnectClock.elapsed() - removed.value()) < _hotplugReconnectMSecs)) {
+        qCDebug(LinkManagerLog) << "Reconnecting returning port" << systemLocation;
+        return false;
+    }
+
+    // A port the probe could not open goes through the timed wait instead
+    if (_autoconnectPortWaitList.contains(systemLocation)) {
+        return (_autoconnectWaitMSecs(systemLocation) > 0);
+    }
+
+    SerialAutoConnectProbe *probe = _autoconnectProbes.value(systemLocation);
+    if (!probe) {
+        // A probe that hears nothing connects no later than the old fixed wait did
+        probe = new SerialAutoConnectProbe(systemLocation, baud, _autoconnectConnectDelayMSecs, this);
+        if (!probe->start()) {
+            delete probe;
+            return (_autoconnectWaitMSecs(systemLocation) > 0);
+        }
+        // Promote at once instead of on the next pass
+        (void) connect(probe, &SerialAutoConnectProbe::finished, this, [this] {
+            _scheduleSerialScan(0);
+        });
+        _autoconnectProbes.insert(systemLocation, probe);
+        return true;
+    }
+
+    bool probing = false;
+    switch (probe->result()) {
+    case SerialAutoConnectProbe::Probing:
+        return true;
+    case SerialAutoConnectProbe::Heartbeat:
+        _autoconnectHeartbeatMSecs = probe->heartbeatMSecs();
+        qCDebug(LinkManagerLog) << "Time to first heartbeat" << systemLocation << _autoconnectHeartbeatMSecs << "ms";
+        emit autoconnectHeartbeat(systemLocation, _autoconnectHeartbeatMSecs);
+        break;
+    case SerialAutoConnectProbe::Silent:
+        // Firmware which only talks once spoken to, connect anyway as we always did
+        qCDebug(LinkManagerLog) << "No heartbeat, connecting anyway" << systemLocation;
+        break;
+    case SerialAutoConnectProbe::Failed:
+        probing = (_autoconnectWaitMSecs(systemLocation) > 0);
+        break;
+    }
+
+    (void) _autoconnectProbes.remove(systemLocation);
+    probe->deleteLater();
+    return probing;
+}
+
+qint64 LinkManager::_autoconnectWaitMSecs(const QString &systemLocation)
+{
+    const qint64 now = _autoconnectClock.elapsed();
+
+    auto waiting = _autoconnectPortWaitList.find(systemLocation);
+    if (waiting == _autoconnectPortWaitList.end()) {
+        // We don't connect to the port the first time we see it. The ability to correctly detect whether we
+        // are in the bootloader is flaky from a cross-platform standpoint. So by putting it on a wait list
+        // and only connecting once the delay has passed we leave enough time for the board to boot up.
+        qCDebug(LinkManagerLog) << "Waiting before autoconnect" << systemLocation;
+        waiting = _autoconnectPortWaitList.insert(systemLocation, now);
+    }
+
+    const qint64 remaining = _autoconnectConnectDelayMSecs - (now - waiting.value());
+    if (remaining <= _autoconnectSlackMSecs) {
+        return 0;
+    }
+    // Look again once the wait is over rather than on the next polling pass
+    _scheduleSerialScan(remaining);
+    return remaining;
+}
+
+void LinkManager::_onSerialPortAdded(const QString &systemLocation)
+{
+    Q_UNUSED(systemLocation);
+    QGCSerialPortInfo::invalidatePorts();
+    _scheduleSerialScan(_hotplugSettleMSecs);
+}
+
+void LinkManager::_onSerialPortRemoved(const QString &systemLocation)
+{
+    QGCSerialPortInfo::invalidatePorts();
+
+    // The link itself learns about it from the monitor too and disconnects
+    const qint64 now = _autoconnectClock.elapsed();
+    for (auto it = _recentlyRemovedPorts.begin(); it != _recentlyRemovedPorts.end();) {
+        it = ((now - it.value()) >= _hotplugReconnectMSecs) ? _recentlyRemovedPorts.erase(it) : (it + 1);
+    }
+    if (_portAlreadyConnected(systemLocation)) {
+        _recentlyRemovedPorts[systemLocation] = now;
+    }
+    (void) _autoconnectPortWaitList.remove(systemLocation);
+    delete _autoconnectProbes.take(systemLocation);
+
+    // Picks up an RTK GPS going away
+    _scheduleSerialScan(_hotplugSettleMSecs);
+}
+
+void LinkManager::_scheduleSerialScan(qint64 delayMSecs)
+{
+    if (!_serialScanTimer->isActive() || (_serialScanTimer->remainingTime() > delayMSecs)) {
+        _serialScanTimer->start(static_cast<int>(delayMSecs));
+    }
+}
+
 bool LinkManager::_allowAutoConnectToBoard(QGCSerialPortInfo::BoardType_t boardType) const
 {
     switch (boardType) {
@@ -9,6 +9,8 @@
 
 #pragma once
 
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
 #include <QtCore/QList>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QStringList>
@@ -26,6 +28,7 @@ Q_DECLARE_LOGGING_CATEGORY(LinkManagerLog)
 Q_DECLARE_LOGGING_CATEGORY(LinkManagerVerboseLog)
 
 class MAVLinkProtocol;
+class SerialAutoConnectProbe;
 class SerialLink;
 class UDPLink;
 class UDPConfiguration;
@@ -100,10 +103,9 @@ public:
 
     void disconnectAll();
 
-    /// Allocates a mavlink channel for use
-    ///     @return Mavlink channel index, invalidMavlinkChannel() for no channels available
-    uint8_t allocateMavlinkChannel();
-    void freeMavlinkChannel(uint8_t channel);
+    /// Allocates a mavlink channel for use, the pool grows as needed so this never fails
+    MAVLinkChannel *allocateMavlinkChannel();
+    void freeMavlinkChannel(MAVLinkChannel *channel);
 
     /// If you are going to hold a reference to a LinkInterface* in your object you must reference count it
     /// by using this method to get access to the shared pointer.
@@ -118,10 +120,13 @@ public:
 
     static bool isLinkUSBDirect(const LinkInterface *link);
 
-    static constexpr uint8_t invalidMavlinkChannel() { return std::numeric_limits<uint8_t>::max(); }
+    /// ms from the last autoconnect port appearing to its first heartbeat, -1 before the first
+    qint64 autoconnectHeartbeatMSecs() const { return _autoconnectHeartbeatMSecs; }
 
 signals:
     void mavlinkSupportForwardingEnabledChanged();
+    /// An autoconnect port sent its first heartbeat and is being promoted to a link
+    void autoconnectHeartbeat(const QString &systemLocation, qint64 msecs);
 
 private slots:
     void _linkDisconnected();
@@ -145,7 +150,6 @@ private:
     bool _configurationsLoaded = false;             ///< true: Link configurations have been loaded
     bool _connectionsSuspended = false;             ///< true: all new connections should not be allowed
     bool _mavlinkSupportForwardingEnabled = false;
-    uint32_t _mavlinkChannelsUsedBitMask = 1;
     QString _connectionsSuspendedReason;            ///< User visible reason for suspension
 
     QList<SharedLinkInterfacePtr> _rgLinks;
@@ -165,6 +169,9 @@ private:
 #else
     static constexpr int _autoconnectConnectDelayMSecs = 1000;
 #endif
+    static constexpr int _autoconnectSlackMSecs = 100;          ///< Coarse timers fire up to 5% early
+    static constexpr int _hotplugSettleMSecs = 50;              ///< Lets the burst of events of one device pass before scanning
+    static constexpr int _hotplugReconnectMSecs = 5000;         ///< A connected port back within this is reconnected without waiting
 
 #ifndef QGC_NO_SERIAL_LINK
 private:
@@ -186,11 +193,28 @@ private:
     void _updateSerialPorts();
     bool _allowAutoConnectToBoard(QGCSerialPortInfo::BoardType_t boardType) const;
     void _addSerialAutoConnectLink();
+    /// Listens on a new port for a heartbeat before it becomes a link. Only for boards which do become a link:
+    /// any other port would be taken and a heartbeat sent over a radio on every pass.
+    ///     @return true: not ready to be connected yet
+    bool _autoconnectProbing(const QString &systemLocation, qint32 baud);
+    /// Fixed boot delay for ports which aren't or can't be probed
+    ///     @return ms the port still has to wait before it is auto connected, 0 to connect now
+    qint64 _autoconnectWaitMSecs(const QString &systemLocation);
+    void _onSerialPortAdded(const QString &systemLocation);
+    void _onSerialPortRemoved(const QString &systemLocation);
+    /// Runs _addSerialAutoConnectLink() in delayMSecs, or sooner if already scheduled sooner
+    void _scheduleSerialScan(qint64 delayMSecs);
     bool _portAlreadyConnected(const QString &portName) const;
     void _filterCompositePorts(QList<QGCSerialPortInfo> &portList);
 
     UdpIODevice *_nmeaSocket = nullptr;
-    QMap<QString, int> _autoconnectPortWaitList;   ///< key: QGCSerialPortInfo::systemLocation, value: wait count
+    QMap<QString, qint64> _autoconnectPortWaitList; ///< key: QGCSerialPortInfo::systemLocation, value: _autoconnectClock time first seen
+    QHash<QString, qint64> _recentlyRemovedPorts;   ///< Connected ports that went away, value: _autoconnectClock time removed
+    QElapsedTimer _autoconnectClock;
+    QHash<QString, SerialAutoConnectProbe*> _autoconnectProbes; ///< key: QGCSerialPortInfo::systemLocation
+    qint64 _autoconnectHeartbeatMSecs = -1;
+    bool _serialHotplug = false;                    ///< true: SerialHotplugMonitor reports port changes, no polling
+    QTimer *_serialScanTimer = nullptr;
     QList<SerialLink*> _activeLinkCheckList;       ///< List of links we are waiting for a vehicle to show up on
     QStringList _commPortList;
     QStringList _commPortDisplayList;
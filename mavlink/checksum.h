@@ -1,5 +1,23 @@
 #pragma once
 
+#include <stddef.h>
+#include <string.h>
+
+// Whole buffer checksums use slice-by-8 tables and, on x86 CPUs with carry-less multiply, a PCLMUL folding
+// kernel. Define MAVLINK_CRC_BYTEWISE to keep the original one byte at a time loop, MAVLINK_CRC_NO_PCLMUL to
+// only drop the PCLMUL kernel. A custom crc_accumulate (HAVE_CRC_ACCUMULATE) always uses the byte loop.
+#if defined(HAVE_CRC_ACCUMULATE) && !defined(MAVLINK_CRC_BYTEWISE)
+#define MAVLINK_CRC_BYTEWISE
+#endif
+
+#ifndef MAVLINK_CRC_BYTEWISE
+#if !defined(MAVLINK_CRC_NO_PCLMUL) && (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#define MAVLINK_CRC_PCLMUL
+#endif
+#endif
+
 #if defined(MAVLINK_USE_CXX_NAMESPACE)
 namespace mavlink {
 #elif defined(__cplusplus)
@@ -13,6 +31,10 @@ extern "C" {
 
 #include <stdint.h>
 
+#ifndef MAVLINK_CRC_BYTEWISE
+#include "checksum_tables.h"
+#endif
+
 /**
  *
  *  CALCULATE THE CHECKSUM
@@ -55,6 +77,120 @@ static inline void crc_init(uint16_t* crcAccum)
 }
 
 
+#ifndef MAVLINK_CRC_BYTEWISE
+/**
+ * @brief Slice-by-8 MCRF4XX CRC16 over a byte buffer, eight bytes per step
+ **/
+static inline uint16_t crc_accumulate_slice8(uint16_t crc, const uint8_t *p, size_t length)
+{
+	while (length >= 8) {
+		const uint16_t x = crc ^ (uint16_t)(p[0] | (p[1] << 8));
+		crc = mavlink_crc_table[7][x & 0xff] ^ mavlink_crc_table[6][x >> 8] ^
+		      mavlink_crc_table[5][p[2]] ^ mavlink_crc_table[4][p[3]] ^
+		      mavlink_crc_table[3][p[4]] ^ mavlink_crc_table[2][p[5]] ^
+		      mavlink_crc_table[1][p[6]] ^ mavlink_crc_table[0][p[7]];
+		p += 8;
+		length -= 8;
+	}
+	while (length--) {
+		crc = (crc >> 8) ^ mavlink_crc_table[0][(crc ^ *p++) & 0xff];
+	}
+	return crc;
+}
+#endif
+
+#ifdef MAVLINK_CRC_PCLMUL
+#define MAVLINK_CRC_PCLMUL_MIN_LEN 96
+
+/**
+ * @brief Carry-less multiply folding kernel, length must be at least 32
+ *
+ * The running CRC is xored into the first two bytes, after which 16 byte blocks are folded forward with
+ * X' = X.lo * (x^191 mod P) + X.hi * (x^127 mod P) + next block. The folded 128 bit remainder is congruent
+ * to the consumed data, so the last block and the tail are finished with the slice-by-8 tables from a
+ * zero register. Constants are bit reflected, coefficient of x^d at bit 63-d.
+ **/
+__attribute__((target("pclmul,sse2")))
+static inline uint16_t crc_accumulate_pclmul(uint16_t crc, const uint8_t *p, size_t length)
+{
+	const __m128i k = _mm_set_epi64x((long long)0x7eea000000000000ULL, (long long)0xa95d000000000000ULL);
+	uint8_t block[16];
+
+	memcpy(block, p, sizeof(block));
+	block[0] ^= (uint8_t)(crc & 0xff);
+	block[1] ^= (uint8_t)(crc >> 8);
+	__m128i x = _mm_loadu_si128((const __m128i *)block);
+	p += 16;
+	length -= 16;
+
+	while (length >= 16) {
+		const __m128i next = _mm_loadu_si128((const __m128i *)p);
+		x = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x00), _mm_clmulepi64_si128(x, k, 0x11)), next);
+		p += 16;
+		length -= 16;
+	}
+
+	_mm_storeu_si128((__m128i *)block, x);
+	crc = crc_accumulate_slice8(0, block, sizeof(block));
+	return crc_accumulate_slice8(crc, p, length);
+}
+
+/* Parsers run on several threads, so the cached answer is read and written atomically */
+static inline int crc_have_pclmul(void)
+{
+	static int have_pclmul = -1;
+	int have = __atomic_load_n(&have_pclmul, __ATOMIC_RELAXED);
+	if (have < 0) {
+		have = __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse2");
+		__atomic_store_n(&have_pclmul, have, __ATOMIC_RELAXED);
+	}
+	return have;
+}
+#endif
+
+/**
+ * @brief Accumulate the MCRF4XX CRC16 over a whole byte span
+ *
+ * Bit-exact with feeding every byte through crc_accumulate(), using the fastest backend available.
+ *
+ * @param crcAccum the already accumulated checksum
+ * @param pBuffer bytes to hash
+ * @param length number of bytes
+ **/
+static inline void crc_accumulate_span(uint16_t *crcAccum, const uint8_t *pBuffer, size_t length)
+{
+#ifdef MAVLINK_CRC_BYTEWISE
+	while (length--) {
+		crc_accumulate(*pBuffer++, crcAccum);
+	}
+#else
+#ifdef MAVLINK_CRC_PCLMUL
+	if (length >= MAVLINK_CRC_PCLMUL_MIN_LEN && crc_have_pclmul()) {
+		*crcAccum = crc_accumulate_pclmul(*crcAccum, pBuffer, length);
+		return;
+	}
+#endif
+	*crcAccum = crc_accumulate_slice8(*crcAccum, pBuffer, length);
+#endif
+}
+
+
+/**
+ * @brief Calculates the CRC16_MCRF4XX checksum on a byte span of any length
+ *
+ * @param  pBuffer buffer containing the byte array to hash
+ * @param  length  length of the byte array
+ * @return the checksum over the buffer bytes
+ **/
+static inline uint16_t crc_calculate_buffer(const uint8_t* pBuffer, size_t length)
+{
+	uint16_t crcTmp;
+	crc_init(&crcTmp);
+	crc_accumulate_span(&crcTmp, pBuffer, length);
+	return crcTmp;
+}
+
+
 /**
  * @brief Calculates the CRC16_MCRF4XX checksum on a byte buffer
  *
@@ -64,30 +200,19 @@ static inline void crc_init(uint16_t* crcAccum)
  **/
 static inline uint16_t crc_calculate(const uint8_t* pBuffer, uint16_t length)
 {
-        uint16_t crcTmp;
-        crc_init(&crcTmp);
-	while (length--) {
-                crc_accumulate(*pBuffer++, &crcTmp);
-        }
-        return crcTmp;
+	return crc_calculate_buffer(pBuffer, length);
 }
 
 
 /**
  * @brief Accumulate the MCRF4XX CRC16 by adding an array of bytes
  *
- * The checksum function adds the hash of one char at a time to the
- * 16 bit checksum (uint16_t).
- *
  * @param data new bytes to hash
  * @param crcAccum the already accumulated checksum
  **/
 static inline void crc_accumulate_buffer(uint16_t *crcAccum, const char *pBuffer, uint16_t length)
 {
-	const uint8_t *p = (const uint8_t *)pBuffer;
-	while (length--) {
-                crc_accumulate(*p++, crcAccum);
-        }
+	crc_accumulate_span(crcAccum, (const uint8_t *)pBuffer, length);
 }
 
 #if defined(MAVLINK_USE_CXX_NAMESPACE) || defined(__cplusplus)
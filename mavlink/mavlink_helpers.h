@@ -121,41 +121,47 @@ MAVLINK_HELPER uint8_t _mav_trim_payload(const char *payload, uint8_t length)
 }
 
 #ifndef MAVLINK_NO_SIGNATURE_CHECK
-/**
- * @brief check a signature block for a packet
+/*
+  hash index slot for a signing stream, linear probing from the hashed position
  */
-MAVLINK_HELPER bool mavlink_signature_check(mavlink_signing_t *signing,
-					    mavlink_signing_streams_t *signing_streams,
-					    const mavlink_message_t *msg)
+MAVLINK_HELPER uint16_t *_mavlink_signing_stream_slot(mavlink_signing_streams_t *signing_streams,
+						      uint8_t sysid, uint8_t compid, uint8_t link_id)
 {
-	if (signing == NULL) {
-		return true;
-	}
-        const uint8_t *p = (const uint8_t *)&msg->magic;
-	const uint8_t *psig = msg->signature;
-        const uint8_t *incoming_signature = psig+7;
-	mavlink_sha256_ctx ctx;
-	uint8_t signature[6];
-	uint16_t i;
-        
-	mavlink_sha256_init(&ctx);
-	mavlink_sha256_update(&ctx, signing->secret_key, sizeof(signing->secret_key));
-	mavlink_sha256_update(&ctx, p, MAVLINK_NUM_HEADER_BYTES);
-	mavlink_sha256_update(&ctx, _MAV_PAYLOAD(msg), msg->len);
-	mavlink_sha256_update(&ctx, msg->ck, 2);
-	mavlink_sha256_update(&ctx, psig, 1+6);
-	mavlink_sha256_final_48(&ctx, signature);
-        if (memcmp(signature, incoming_signature, 6) != 0) {
-                signing->last_status = MAVLINK_SIGNING_STATUS_BAD_SIGNATURE;
-		return false;
+	const uint32_t key = (uint32_t)sysid | ((uint32_t)compid << 8) | ((uint32_t)link_id << 16);
+	uint32_t pos = ((key * 2654435761UL) >> 8) % MAVLINK_SIGNING_STREAMS_HASH_SIZE;
+	uint16_t probes;
+	for (probes = 0; probes < MAVLINK_SIGNING_STREAMS_HASH_SIZE; probes++) {
+		uint16_t *slot = &signing_streams->hash_index[pos];
+		if (*slot == 0) {
+			return slot;
+		}
+		const uint16_t i = *slot - 1;
+		if (signing_streams->stream[i].sysid == sysid &&
+		    signing_streams->stream[i].compid == compid &&
+		    signing_streams->stream[i].link_id == link_id) {
+			return slot;
+		}
+		pos = (pos + 1) % MAVLINK_SIGNING_STREAMS_HASH_SIZE;
 	}
+	return NULL;
+}
 
+/*
+  replay protection shared by the message and frame signature checks, psig points at the
+  7 byte link_id + timestamp part of a signature that has already been verified
+ */
+MAVLINK_HELPER bool _mavlink_signature_check_stream(mavlink_signing_t *signing,
+						    mavlink_signing_streams_t *signing_streams,
+						    uint8_t sysid, uint8_t compid, const uint8_t *psig)
+{
 	// now check timestamp
 	union tstamp {
 	    uint64_t t64;
 	    uint8_t t8[8];
 	} tstamp;
 	uint8_t link_id = psig[0];
+	uint16_t *slot;
+	uint16_t i;
 	tstamp.t64 = 0;
 	memcpy(tstamp.t8, psig+1, 6);
 
@@ -163,17 +169,11 @@ MAVLINK_HELPER bool mavlink_signature_check(mavlink_signing_t *signing,
                 signing->last_status = MAVLINK_SIGNING_STATUS_NO_STREAMS;
                 return false;
 	}
-	
+
 	// find stream
-	for (i=0; i<signing_streams->num_signing_streams; i++) {
-		if (msg->sysid == signing_streams->stream[i].sysid &&
-		    msg->compid == signing_streams->stream[i].compid &&
-		    link_id == signing_streams->stream[i].link_id) {
-			break;
-		}
-	}
-	if (i == signing_streams->num_signing_streams) {
-		if (signing_streams->num_signing_streams >= MAVLINK_MAX_SIGNING_STREAMS) {
+	slot = _mavlink_signing_stream_slot(signing_streams, sysid, compid, link_id);
+	if (slot == NULL || *slot == 0) {
+		if (slot == NULL || signing_streams->num_signing_streams >= MAVLINK_MAX_SIGNING_STREAMS) {
 			// over max number of streams
                         signing->last_status = MAVLINK_SIGNING_STATUS_TOO_MANY_STREAMS;
                         return false;
@@ -184,12 +184,15 @@ MAVLINK_HELPER bool mavlink_signature_check(mavlink_signing_t *signing,
                         return false;
 		}
 		// add new stream
-		signing_streams->stream[i].sysid = msg->sysid;
-		signing_streams->stream[i].compid = msg->compid;
+		i = signing_streams->num_signing_streams;
+		signing_streams->stream[i].sysid = sysid;
+		signing_streams->stream[i].compid = compid;
 		signing_streams->stream[i].link_id = link_id;
 		signing_streams->num_signing_streams++;
+		*slot = i + 1;
 	} else {
 		union tstamp last_tstamp;
+		i = *slot - 1;
 		last_tstamp.t64 = 0;
 		memcpy(last_tstamp.t8, signing_streams->stream[i].timestamp_bytes, 6);
 		if (tstamp.t64 <= last_tstamp.t64) {
@@ -209,6 +212,73 @@ MAVLINK_HELPER bool mavlink_signature_check(mavlink_signing_t *signing,
         signing->last_status = MAVLINK_SIGNING_STATUS_OK;
         return true;
 }
+
+/**
+ * @brief check a signature block for a packet
+ */
+MAVLINK_HELPER bool mavlink_signature_check(mavlink_signing_t *signing,
+					    mavlink_signing_streams_t *signing_streams,
+					    const mavlink_message_t *msg)
+{
+	if (signing == NULL) {
+		return true;
+	}
+        const uint8_t *p = (const uint8_t *)&msg->magic;
+	const uint8_t *psig = msg->signature;
+        const uint8_t *incoming_signature = psig+7;
+	mavlink_sha256_ctx ctx;
+	uint8_t signature[6];
+
+	mavlink_sha256_init(&ctx);
+	mavlink_sha256_update(&ctx, signing->secret_key, sizeof(signing->secret_key));
+	mavlink_sha256_update(&ctx, p, MAVLINK_NUM_HEADER_BYTES);
+	mavlink_sha256_update(&ctx, _MAV_PAYLOAD(msg), msg->len);
+	mavlink_sha256_update(&ctx, msg->ck, 2);
+	mavlink_sha256_update(&ctx, psig, 1+6);
+	mavlink_sha256_final_48(&ctx, signature);
+        if (memcmp(signature, incoming_signature, 6) != 0) {
+                signing->last_status = MAVLINK_SIGNING_STATUS_BAD_SIGNATURE;
+		return false;
+	}
+
+	return _mavlink_signature_check_stream(signing, signing_streams, msg->sysid, msg->compid, psig);
+}
+
+/**
+ * @brief check the signature of a complete, signed MAVLink 2 frame as received on the wire
+ *
+ * Same result as mavlink_signature_check() without unpacking the frame into a mavlink_message_t.
+ *
+ * @param frame frame bytes, starting with the magic byte and ending with the signature
+ * @param frame_len length of the frame
+ */
+MAVLINK_HELPER bool mavlink_signature_check_frame(mavlink_signing_t *signing,
+						  mavlink_signing_streams_t *signing_streams,
+						  const uint8_t *frame, uint16_t frame_len)
+{
+	if (signing == NULL) {
+		return true;
+	}
+	if (frame_len < MAVLINK_NUM_NON_PAYLOAD_BYTES + MAVLINK_SIGNATURE_BLOCK_LEN) {
+                signing->last_status = MAVLINK_SIGNING_STATUS_BAD_SIGNATURE;
+		return false;
+	}
+	const uint8_t *psig = frame + frame_len - MAVLINK_SIGNATURE_BLOCK_LEN;
+	mavlink_sha256_ctx ctx;
+	uint8_t signature[6];
+
+	// the signature covers everything up to and including the link id and timestamp
+	mavlink_sha256_init(&ctx);
+	mavlink_sha256_update(&ctx, signing->secret_key, sizeof(signing->secret_key));
+	mavlink_sha256_update(&ctx, frame, frame_len - 6);
+	mavlink_sha256_final_48(&ctx, signature);
+        if (memcmp(signature, psig+7, 6) != 0) {
+                signing->last_status = MAVLINK_SIGNING_STATUS_BAD_SIGNATURE;
+		return false;
+	}
+
+	return _mavlink_signature_check_stream(signing, signing_streams, frame[5], frame[6], psig);
+}
 #endif
 
 
@@ -960,6 +1030,32 @@ MAVLINK_HELPER unsigned int mavlink_get_proto_version(uint8_t chan)
 	}
 }
 
+/**
+ * Same as mavlink_parse_char() on caller owned parse state instead of a channel index
+ *
+ * @param rxmsg    parse buffer of the stream
+ * @param status   status of the stream
+ */
+MAVLINK_HELPER uint8_t mavlink_parse_char_buffer(mavlink_message_t* rxmsg, mavlink_status_t* status, uint8_t c, mavlink_message_t* r_message, mavlink_status_t* r_mavlink_status)
+{
+    uint8_t msg_received = mavlink_frame_char_buffer(rxmsg, status, c, r_message, r_mavlink_status);
+    if (msg_received == MAVLINK_FRAMING_BAD_CRC ||
+	msg_received == MAVLINK_FRAMING_BAD_SIGNATURE) {
+	    // we got a bad CRC. Treat as a parse failure
+	    _mav_parse_error(status);
+	    status->msg_received = MAVLINK_FRAMING_INCOMPLETE;
+	    status->parse_state = MAVLINK_PARSE_STATE_IDLE;
+	    if (c == MAVLINK_STX)
+	    {
+		    status->parse_state = MAVLINK_PARSE_STATE_GOT_STX;
+		    rxmsg->len = 0;
+		    mavlink_start_checksum(rxmsg);
+	    }
+	    return 0;
+    }
+    return msg_received;
+}
+
 /**
  * This is a convenience function which handles the complete MAVLink parsing.
  * the function will parse one byte at a time and return the complete packet once
@@ -1003,24 +1099,11 @@ MAVLINK_HELPER unsigned int mavlink_get_proto_version(uint8_t chan)
  */
 MAVLINK_HELPER uint8_t mavlink_parse_char(uint8_t chan, uint8_t c, mavlink_message_t* r_message, mavlink_status_t* r_mavlink_status)
 {
-    uint8_t msg_received = mavlink_frame_char(chan, c, r_message, r_mavlink_status);
-    if (msg_received == MAVLINK_FRAMING_BAD_CRC ||
-	msg_received == MAVLINK_FRAMING_BAD_SIGNATURE) {
-	    // we got a bad CRC. Treat as a parse failure
-	    mavlink_message_t* rxmsg = mavlink_get_channel_buffer(chan);
-	    mavlink_status_t* status = mavlink_get_channel_status(chan);
-	    _mav_parse_error(status);
-	    status->msg_received = MAVLINK_FRAMING_INCOMPLETE;
-	    status->parse_state = MAVLINK_PARSE_STATE_IDLE;
-	    if (c == MAVLINK_STX)
-	    {
-		    status->parse_state = MAVLINK_PARSE_STATE_GOT_STX;
-		    rxmsg->len = 0;
-		    mavlink_start_checksum(rxmsg);
-	    }
-	    return 0;
-    }
-    return msg_received;
+	return mavlink_parse_char_buffer(mavlink_get_channel_buffer(chan),
+					 mavlink_get_channel_status(chan),
+					 c,
+					 r_message,
+					 r_mavlink_status);
 }
 
 /**
@@ -42,6 +42,15 @@
 */
 #ifndef HAVE_MAVLINK_SHA256
 
+#ifndef MAVLINK_SHA256_NO_ACCEL
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#include <immintrin.h>
+#elif defined(__aarch64__) && (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO))
+#include <arm_neon.h>
+#endif
+#endif
+
 #ifdef MAVLINK_USE_CXX_NAMESPACE
 namespace mavlink {
 #endif
@@ -88,6 +97,122 @@ static const uint32_t mavlink_sha256_constant_256[64] = {
     0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
 };
 
+/*
+  hardware block functions, selected at runtime on x86 (SHA-NI) and at compile time on ARMv8
+  (crypto extensions). Define MAVLINK_SHA256_NO_ACCEL to always use the portable code.
+ */
+#ifndef MAVLINK_SHA256_NO_ACCEL
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define MAVLINK_SHA256_SHANI
+#elif defined(__aarch64__) && (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO))
+#define MAVLINK_SHA256_ARMV8
+#endif
+#endif
+
+#ifdef MAVLINK_SHA256_SHANI
+__attribute__((target("sha,ssse3,sse4.1")))
+static inline void mavlink_sha256_blocks_shani(uint32_t state[8], const uint8_t *data, uint32_t blocks)
+{
+    const __m128i MASK = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i TMP = _mm_loadu_si128((const __m128i *)&state[0]);
+    __m128i STATE1 = _mm_loadu_si128((const __m128i *)&state[4]);
+    __m128i STATE0;
+
+    TMP = _mm_shuffle_epi32(TMP, 0xB1);          // CDAB
+    STATE1 = _mm_shuffle_epi32(STATE1, 0x1B);    // EFGH
+    STATE0 = _mm_alignr_epi8(TMP, STATE1, 8);    // ABEF
+    STATE1 = _mm_blend_epi16(STATE1, TMP, 0xF0); // CDGH
+
+    while (blocks--) {
+        const __m128i ABEF_SAVE = STATE0;
+        const __m128i CDGH_SAVE = STATE1;
+        __m128i W[4];
+        int i;
+
+        for (i = 0; i < 4; i++) {
+            W[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 16*i)), MASK);
+        }
+
+        // 16 groups of 4 rounds, scheduling the message words for group i+4 as we go
+        for (i = 0; i < 16; i++) {
+            __m128i MSG = _mm_add_epi32(W[i & 3], _mm_loadu_si128((const __m128i *)&mavlink_sha256_constant_256[4*i]));
+            STATE1 = _mm_sha256rnds2_epu32(STATE1, STATE0, MSG);
+            MSG = _mm_shuffle_epi32(MSG, 0x0E);
+            STATE0 = _mm_sha256rnds2_epu32(STATE0, STATE1, MSG);
+            if (i < 12) {
+                TMP = _mm_add_epi32(_mm_sha256msg1_epu32(W[i & 3], W[(i + 1) & 3]), _mm_alignr_epi8(W[(i + 3) & 3], W[(i + 2) & 3], 4));
+                W[i & 3] = _mm_sha256msg2_epu32(TMP, W[(i + 3) & 3]);
+            }
+        }
+
+        STATE0 = _mm_add_epi32(STATE0, ABEF_SAVE);
+        STATE1 = _mm_add_epi32(STATE1, CDGH_SAVE);
+        data += 64;
+    }
+
+    TMP = _mm_shuffle_epi32(STATE0, 0x1B);       // FEBA
+    STATE1 = _mm_shuffle_epi32(STATE1, 0xB1);    // DCHG
+    STATE0 = _mm_blend_epi16(TMP, STATE1, 0xF0); // DCBA
+    STATE1 = _mm_alignr_epi8(STATE1, TMP, 8);    // ABEF
+
+    _mm_storeu_si128((__m128i *)&state[0], STATE0);
+    _mm_storeu_si128((__m128i *)&state[4], STATE1);
+}
+
+// Signing runs on several parser threads, so the cached answer is read and written atomically
+static inline int mavlink_sha256_have_shani(void)
+{
+    static int have_shani = -1;
+    int have = __atomic_load_n(&have_shani, __ATOMIC_RELAXED);
+    if (have < 0) {
+        unsigned int eax, ebx, ecx, edx;
+        have = __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_SSSE3) && (ecx & bit_SSE4_1) &&
+               __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & bit_SHA);
+        __atomic_store_n(&have_shani, have, __ATOMIC_RELAXED);
+    }
+    return have;
+}
+#endif
+
+#ifdef MAVLINK_SHA256_ARMV8
+static inline void mavlink_sha256_blocks_armv8(uint32_t state[8], const uint8_t *data, uint32_t blocks)
+{
+    uint32x4_t STATE0 = vld1q_u32(&state[0]);
+    uint32x4_t STATE1 = vld1q_u32(&state[4]);
+
+    while (blocks--) {
+        const uint32x4_t ABCD_SAVE = STATE0;
+        const uint32x4_t EFGH_SAVE = STATE1;
+        uint32x4_t W[4];
+        int i;
+
+        for (i = 0; i < 4; i++) {
+            W[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16*i)));
+        }
+
+        for (i = 0; i < 16; i++) {
+            const uint32x4_t MSG = vaddq_u32(W[i & 3], vld1q_u32(&mavlink_sha256_constant_256[4*i]));
+            const uint32x4_t TMP = STATE0;
+            if (i < 12) {
+                W[i & 3] = vsha256su0q_u32(W[i & 3], W[(i + 1) & 3]);
+            }
+            STATE0 = vsha256hq_u32(STATE0, STATE1, MSG);
+            STATE1 = vsha256h2q_u32(STATE1, TMP, MSG);
+            if (i < 12) {
+                W[i & 3] = vsha256su1q_u32(W[i & 3], W[(i + 2) & 3], W[(i + 3) & 3]);
+            }
+        }
+
+        STATE0 = vaddq_u32(STATE0, ABCD_SAVE);
+        STATE1 = vaddq_u32(STATE1, EFGH_SAVE);
+        data += 64;
+    }
+
+    vst1q_u32(&state[0], STATE0);
+    vst1q_u32(&state[4], STATE1);
+}
+#endif
+
 MAVLINK_HELPER void mavlink_sha256_init(mavlink_sha256_ctx *m)
 {
     m->sz[0] = 0;
@@ -149,6 +274,33 @@ static inline void mavlink_sha256_calc(mavlink_sha256_ctx *m, uint32_t *in)
     m->counter[7] += HH;
 }
 
+/*
+  process whole 64 byte blocks, using the CPU's SHA-256 instructions when available
+ */
+MAVLINK_HELPER void mavlink_sha256_blocks(mavlink_sha256_ctx *m, const uint8_t *data, uint32_t blocks)
+{
+#ifdef MAVLINK_SHA256_SHANI
+    if (mavlink_sha256_have_shani()) {
+        mavlink_sha256_blocks_shani(m->counter, data, blocks);
+        return;
+    }
+#endif
+#ifdef MAVLINK_SHA256_ARMV8
+    mavlink_sha256_blocks_armv8(m->counter, data, blocks);
+#else
+    while (blocks--) {
+        int i;
+        uint32_t current[16];
+        for (i = 0; i < 16; i++){
+            const uint8_t *p1 = data + 4*i;
+            current[i] = ((uint32_t)p1[0] << 24) | ((uint32_t)p1[1] << 16) | ((uint32_t)p1[2] << 8) | (uint32_t)p1[3];
+        }
+        mavlink_sha256_calc(m, current);
+        data += 64;
+    }
+#endif
+}
+
 MAVLINK_HELPER void mavlink_sha256_update(mavlink_sha256_ctx *m, const void *v, uint32_t len)
 {
     const unsigned char *p = (const unsigned char *)v;
@@ -160,7 +312,16 @@ MAVLINK_HELPER void mavlink_sha256_update(mavlink_sha256_ctx *m, const void *v,
 	++m->sz[1];
     offset = (old_sz / 8) % 64;
     while(len > 0){
-	uint32_t l = 64 - offset;
+	uint32_t l;
+        if (offset == 0 && len >= 64) {
+            // hash full blocks straight from the input
+            const uint32_t blocks = len / 64;
+            mavlink_sha256_blocks(m, p, blocks);
+            p += blocks * 64;
+            len -= blocks * 64;
+            continue;
+        }
+	l = 64 - offset;
         if (len < l) {
             l = len;
         }
@@ -169,18 +330,7 @@ MAVLINK_HELPER void mavlink_sha256_update(mavlink_sha256_ctx *m, const void *v,
 	p += l;
 	len -= l;
 	if(offset == 64){
-	    int i;
-	    uint32_t current[16];
-	    const uint32_t *u = m->u.save_u32;
-	    for (i = 0; i < 16; i++){
-                const uint8_t *p1 = (const uint8_t *)&u[i];
-                uint8_t *p2 = (uint8_t *)&current[i];
-                p2[0] = p1[3];
-                p2[1] = p1[2];
-                p2[2] = p1[1];
-                p2[3] = p1[0];
-	    }
-	    mavlink_sha256_calc(m, current);
+	    mavlink_sha256_blocks(m, m->u.save_bytes, 1);
 	    offset = 0;
 	}
     }
@@ -272,6 +272,13 @@ typedef struct __mavlink_signing {
 #ifndef MAVLINK_MAX_SIGNING_STREAMS
 #define MAVLINK_MAX_SIGNING_STREAMS 16
 #endif
+/*
+  open addressing index over stream[], keyed by (sysid, compid, link_id). Kept at most half full so
+  lookups stay O(1) however many streams are in use. Streams are never removed individually.
+ */
+#ifndef MAVLINK_SIGNING_STREAMS_HASH_SIZE
+#define MAVLINK_SIGNING_STREAMS_HASH_SIZE (2 * MAVLINK_MAX_SIGNING_STREAMS)
+#endif
 typedef struct __mavlink_signing_streams {
     uint16_t num_signing_streams;
     struct __mavlink_signing_stream {
@@ -280,6 +287,7 @@ typedef struct __mavlink_signing_streams {
         uint8_t compid;               ///< Remote component ID
         uint8_t timestamp_bytes[6];   ///< Timestamp, in microseconds since UNIX epoch GMT
     } stream[MAVLINK_MAX_SIGNING_STREAMS];
+    uint16_t hash_index[MAVLINK_SIGNING_STREAMS_HASH_SIZE]; ///< stream index + 1, 0 for an empty slot
 } mavlink_signing_streams_t;
 
 
@@ -1,6 +1,7 @@
 #include "mavlinkprotocol.h"
 #include "linkmanager.h"
 #include "bridge.h"
+#include "MAVLinkDispatcher.h"
 
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
     #include <QtCore/qapplicationstatic.h>
@@ -22,7 +23,9 @@ MAVLinkProtocol::MAVLinkProtocol(QObject *parent)
     qDebug()<<"create mavlink protocol";
     QSettings settings;
     settings.setValue("mavlinkVersion", "2");
-
+    _bulkFraming = settings.value(_bulkFramingKey, true).toBool();
+    _workerFraming = settings.value(_workerFramingKey, true).toBool();
+    _routing = settings.value(_routingKey, true).toBool();
 }
 
 MAVLinkProtocol::~MAVLinkProtocol()
@@ -36,6 +39,11 @@ MAVLinkProtocol *MAVLinkProtocol::instance()
 }
 
 void MAVLinkProtocol::receiveBytes(LinkInterface *link, const QByteArray &data)
+{
+    receiveChannelBytes(link, nullptr, data);
+}
+
+void MAVLinkProtocol::receiveChannelBytes(LinkInterface *link, MAVLinkChannel *mavlinkChannel, const QByteArray &data)
 {
     const SharedLinkInterfacePtr linkPtr = LinkManager::instance()->sharedLinkInterfacePointerForLink(link);
     if (!linkPtr) {
@@ -43,79 +51,142 @@ void MAVLinkProtocol::receiveBytes(LinkInterface *link, const QByteArray &data)
         return;
     }
 
+    if (!mavlinkChannel) {
+        mavlinkChannel = link->mavlinkChannel();
+        if (!mavlinkChannel) {
+            return;
+        }
+    }
+
+    if (_bulkFraming) {
+        (void) mavlinkChannel->frame(data, [this, link](const MAVLinkFrameView &frame) {
+            _handleFrame(link, frame);
+        });
+        return;
+    }
+
     for(const uint8_t &byte: data){
-        const uint8_t mavlinkChannel = link->mavlinkChannel();
         mavlink_message_t message{};
         mavlink_status_t status{};
 
-        if (mavlink_parse_char(mavlinkChannel, byte, &message, &status) != MAVLINK_FRAMING_OK) {
+        if (mavlink_parse_char_buffer(&mavlinkChannel->rxBuffer, &mavlinkChannel->status, byte, &message, &status) != MAVLINK_FRAMING_OK) {
             continue;
         }
 
-        if(link->linkConfiguration()->type() == LinkConfiguration::TypeSerial){
+        uint8_t buf[MAVLINK_MAX_PACKET_LEN]{};
+        const uint16_t len = mavlink_msg_to_send_buffer(buf, &message);
+        _handleFrame(link, MAVLinkFrameView(QByteArray(reinterpret_cast<const char*>(buf), len)));
+    }
+}
+
+void MAVLinkProtocol::receiveFrames(LinkInterface *link, const MAVLinkFrameView *frames, int count)
+{
+    const SharedLinkInterfacePtr linkPtr = LinkManager::instance()->sharedLinkInterfacePointerForLink(link);
+    if (!linkPtr) {
+        qCDebug(MAVLinkProtocolLog) << "receiveFrames: link gone!" << count << "frames arrived too late";
+        return;
+    }
 
-            _forward(message);
+    for (int i = 0; i < count; i++) {
+        _handleFrame(link, frames[i]);
+    }
+}
 
-        }else{
-            _forwardtoPixhawk(message);
-        }
+void MAVLinkProtocol::_handleFrame(LinkInterface *link, const MAVLinkFrameView &frame)
+{
+    _routingTable.learn(link, frame.sysid(), frame.compid());
+
+    if (_routing) {
+        _route(link, frame);
+    } else if(link->linkConfiguration()->type() == LinkConfiguration::TypeSerial){
 
-        emit messageReceived(link, message);
-        continue;
+        _forward(frame.bytes());
+
+    }else{
+        _forwardtoPixhawk(frame.bytes());
     }
+
+    emit frameReceived(link, frame);
+
+    MAVLinkDispatcher::instance()->dispatch(link, frame);
 }
 
-void MAVLinkProtocol::_forwardtoPixhawk(const mavlink_message_t &message)
+void MAVLinkProtocol::_route(LinkInterface *link, const MAVLinkFrameView &frame)
 {
+    const bool fromVehicle = (link->linkConfiguration()->type() == LinkConfiguration::TypeSerial);
+
+    MAVLinkRoutingTable::LinkList targets;
+    const uint8_t targetSystem = frame.targetSystem();
+    if ((targetSystem == 0) || !_routingTable.route(targetSystem, frame.targetComponent(), link, targets)) {
+        // Broadcast, or a target not heard from yet
+        if (fromVehicle) {
+            _forward(frame.bytes());
+        } else {
+            _forwardToVehicles(link, frame.bytes());
+        }
+        return;
+    }
 
+    // An empty list means the target sits behind the source link, nothing goes out
+    bool toGcs = false;
+    for (LinkInterface *const target : targets) {
+        const SharedLinkInterfacePtr targetLink = LinkManager::instance()->sharedLinkInterfacePointerForLink(target);
+        if (!targetLink) {
+            continue;
+        }
+        if (targetLink->linkConfiguration()->type() == LinkConfiguration::TypeSerial) {
+            (void) targetLink->writeBytesThreadSafe(frame.bytes());
+        } else {
+            // The GCS is heard on both UDP links, send through the one Bridge picked as primary
+            toGcs = true;
+        }
+    }
 
+    if (toGcs && fromVehicle) {
+        _forward(frame.bytes());
+    }
+}
 
+void MAVLinkProtocol::_forwardToVehicles(const LinkInterface *source, const QByteArray &frame)
+{
+    const QList<SharedLinkInterfacePtr> links = LinkManager::instance()->links();
+    for (const SharedLinkInterfacePtr &link : links) {
+        if ((link.get() != source) && (link->linkConfiguration()->type() == LinkConfiguration::TypeSerial)) {
+            (void) link->writeBytesThreadSafe(frame);
+        }
+    }
+}
+
+void MAVLinkProtocol::_forwardtoPixhawk(const QByteArray &frame)
+{
     SharedLinkInterfacePtr pixhawkLink = LinkManager::instance()->mavlinkPixhawkLink();
     if (!pixhawkLink) {
         return;
     }
 
-    uint8_t buf[MAVLINK_MAX_PACKET_LEN]{};
-    const uint16_t len = mavlink_msg_to_send_buffer(buf, &message);
-    (void) pixhawkLink->writeBytesThreadSafe(reinterpret_cast<const char*>(buf), len);
+    (void) pixhawkLink->writeBytesThreadSafe(frame);
 }
 
-void MAVLinkProtocol::_forward(const mavlink_message_t &message)
+void MAVLinkProtocol::_forward(const QByteArray &frame)
 {
-    uint8_t buf[MAVLINK_MAX_PACKET_LEN]{};
-    const uint16_t len = mavlink_msg_to_send_buffer(buf, &message);
-
     SharedLinkInterfacePtr primaryLink = Bridge::instance()->primaryLink().lock();
 
     if(primaryLink){
-        (void) primaryLink->writeBytesThreadSafe(reinterpret_cast<const char*>(buf), len);
+        (void) primaryLink->writeBytesThreadSafe(frame);
     }
 
 }
 
 void MAVLinkProtocol::resetMetadataForLink(LinkInterface *link)
 {
-    const uint8_t channel = link->mavlinkChannel();
+    MAVLinkChannel *const channel = link->mavlinkChannel();
+    if (channel) {
+        channel->parser.reset();
+    }
+    _routingTable.removeLink(link);
     //_totalReceiveCounter[channel] = 0;
     //_totalLossCounter[channel] = 0;
     //_runningLossPercent[channel] = 0.f;
 
     //link->setDecodedFirstMavlinkPacket(false);
 }
-
-#ifdef MAVLINK_EXTERNAL_RX_STATUS
-mavlink_status_t m_mavlink_status[MAVLINK_COMM_NUM_BUFFERS];
-#endif
-
-#ifdef MAVLINK_GET_CHANNEL_STATUS
-mavlink_status_t* mavlink_get_channel_status(uint8_t channel)
-{
-    // 檢查邊界，防止陣列溢位
-    if (channel >= MAVLINK_COMM_NUM_BUFFERS) {
-        return nullptr;
-    }
-
-    // 回傳全域陣列中對應通道的地址
-    return &m_mavlink_status[channel];
-}
-#endif
@@ -4,6 +4,8 @@
 #include <QObject>
 
 #include "MAVLinkLib.h"
+#include "MAVLinkFrameView.h"
+#include "MAVLinkRoutingTable.h"
 #include "linkinterface.h"
 class MAVLinkProtocol : public QObject
 {
@@ -17,13 +19,41 @@ public:
 
 
     void receiveBytes(LinkInterface *link, const QByteArray &data);
+    /// Same as receiveBytes, parsing with the given channel instead of the link channel (nullptr: link channel)
+    void receiveChannelBytes(LinkInterface *link, MAVLinkChannel *channel, const QByteArray &data);
+    /// Routes frames already validated by a link worker thread, see LinkInterface::framesReceived
+    void receiveFrames(LinkInterface *link, const MAVLinkFrameView *frames, int count);
     void resetMetadataForLink(LinkInterface *link);
+
+    /// true: link workers do the framing on their own threads and hand over complete frames
+    bool workerFraming() const { return _bulkFraming && _workerFraming; }
     void forward(LinkInterface *link, const mavlink_message_t &message);
+
+    /// Where every sysid/compid was last heard, main thread only
+    const MAVLinkRoutingTable &routingTable() const { return _routingTable; }
 signals:
-    void messageReceived(LinkInterface *link, const mavlink_message_t &message);
+    /// Header only view of every valid frame, use this for routing.
+    /// Consumers of specific messages subscribe through MAVLinkDispatcher instead.
+    /// The view may borrow link memory and is only valid during the emission, copy bytes() to keep it.
+    void frameReceived(LinkInterface *link, const MAVLinkFrameView &frame);
 private:
-    void _forward(const mavlink_message_t &message);
-    void _forwardtoPixhawk(const mavlink_message_t &message);
+    /// Forwards the frame bytes untouched and notifies subscribers
+    void _handleFrame(LinkInterface *link, const MAVLinkFrameView &frame);
+    /// Targeted frames go only to the links hosting their target, the rest to every link on the other side
+    void _route(LinkInterface *link, const MAVLinkFrameView &frame);
+    void _forward(const QByteArray &frame);
+    void _forwardtoPixhawk(const QByteArray &frame);
+    /// Every serial link but source
+    void _forwardToVehicles(const LinkInterface *source, const QByteArray &frame);
+
+    bool _bulkFraming = true;   ///< false: fall back to byte-wise mavlink_parse_char
+    bool _workerFraming = true;
+    bool _routing = true;       ///< false: everything from serial to the primary link, everything else to the first serial link
+    MAVLinkRoutingTable _routingTable;
+
+    static constexpr const char *_bulkFramingKey = "bulkFraming";
+    static constexpr const char *_workerFramingKey = "workerFraming";
+    static constexpr const char *_routingKey = "mavlinkRouting";
 };
 
 
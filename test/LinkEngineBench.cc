@@ -0,0 +1,290 @@
+// The receive engines of UDPWorker and SerialWorker against each other on loopback. UDP datagrams come in
+// through recvmmsg() (UDPReceiveBatch) and io_uring (UDPUringReceiver). Serial frames cross a
+// pseudo-terminal and are read by TermiosSerialPort or SerialUringEngine, which echo every read back,
+// so the write path is measured as well. Every run is paced (pauses like a telemetry stream) and then
+// burst (as fast as the sender goes). It reports packets per second and the CPU time of the receiving
+// thread per packet.
+//
+//   LinkEngineBench [packets per run], Linux only
+
+#include "SerialUringEngine.h"
+#include "TermiosSerialPort.h"
+#include "UDPReceiveBatch.h"
+#include "UDPUringReceiver.h"
+
+#include <QtCore/QLoggingCategory>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pty.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+// The engines log through the categories of their links
+Q_LOGGING_CATEGORY(UDPLinkLog, "UDPLinkLog")
+Q_LOGGING_CATEGORY(SerialLinkLog, "SerialLinkLog")
+
+namespace {
+
+constexpr size_t packetSize = 60;       ///< A typical telemetry frame
+constexpr int pauseEvery = 64;          ///< Paced senders sleep after this many packets
+constexpr int pauseUs = 20;
+constexpr int idleTimeoutMs = 1000;     ///< Ends a run that lost packets
+
+double threadCpuSeconds()
+{
+    rusage usage;
+    (void) getrusage(RUSAGE_THREAD, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) + ((usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6);
+}
+
+struct Result_t {
+    long packets = 0;
+    double seconds = 0;
+    double cpuSeconds = 0;
+};
+
+void report(const char *link, const char *engine, bool burst, long expected, const Result_t &result, const char *note = "")
+{
+    const long packets = (result.packets > 0) ? result.packets : 1;
+    printf("%-6s %-8s %-5s %8ld/%ld packets %8.0f pps %7.0f ns cpu/packet%s\n",
+           link, engine, burst ? "burst" : "paced", result.packets, expected,
+           result.packets / result.seconds, (result.cpuSeconds * 1e9) / packets, note);
+}
+
+/// Sends count datagrams to port from its own thread, paced unless burst
+std::thread udpSender(quint16 port, long count, bool burst)
+{
+    return std::thread([port, count, burst] {
+        const int sender = socket(AF_INET, SOCK_DGRAM, 0);
+        sockaddr_in destination{};
+        destination.sin_family = AF_INET;
+        destination.sin_port = htons(port);
+        destination.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        char packet[packetSize] = { static_cast<char>(0xFD) };
+        for (long i = 0; i < count; i++) {
+            while (sendto(sender, packet, sizeof(packet), 0, reinterpret_cast<sockaddr*>(&destination), sizeof(destination)) < 0) {
+                std::this_thread::yield();
+            }
+            if (!burst && ((i % pauseEvery) == 0)) {
+                (void) usleep(pauseUs);
+            }
+        }
+        (void) close(sender);
+    });
+}
+
+bool runUdp(bool uring, bool burst, long count)
+{
+    const int receiver = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+    const int receiveBuffer = 8 << 20;
+    (void) setsockopt(receiver, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addressLength = sizeof(address);
+    (void) bind(receiver, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    (void) getsockname(receiver, reinterpret_cast<sockaddr*>(&address), &addressLength);
+
+    UDPUringReceiver uringReceiver;
+    UDPReceiveBatch receiveBatch;
+    if (uring && !uringReceiver.open(receiver)) {
+        printf("udp    io_uring not available\n");
+        (void) close(receiver);
+        return false;
+    }
+    if (!uring && !receiveBatch.open(receiver)) {
+        printf("udp    recvmmsg not available\n");
+        (void) close(receiver);
+        return false;
+    }
+
+    Result_t result;
+    long truncated = 0;
+    const double cpuStart = threadCpuSeconds();
+    const auto start = std::chrono::steady_clock::now();
+    std::thread sender = udpSender(ntohs(address.sin_port), count, burst);
+
+    pollfd waiter{ uring ? uringReceiver.eventFd() : receiveBatch.descriptor(), POLLIN, 0 };
+    while (result.packets < count) {
+        if (poll(&waiter, 1, idleTimeoutMs) == 0) {
+            break;
+        }
+        if (uring) {
+            const int received = uringReceiver.reap([&result, &truncated](const char *, qint64, const QHostAddress &, quint16, bool, bool isTruncated) {
+                result.packets++;
+                truncated += isTruncated ? 1 : 0;
+            });
+            if (received < 0) {
+                break;
+            }
+            continue;
+        }
+        int received;
+        do {
+            received = receiveBatch.receive();
+            for (int i = 0; i < received; i++) {
+                (void) receiveBatch.senderAddress(i);
+                truncated += receiveBatch.isTruncated(i) ? 1 : 0;
+            }
+            result.packets += (received > 0) ? received : 0;
+        } while (received == UDPReceiveBatch::batchSize);
+    }
+
+    result.cpuSeconds = threadCpuSeconds() - cpuStart;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    sender.join();
+    uringReceiver.close();
+    receiveBatch.close();
+    (void) close(receiver);
+
+    report("udp", uring ? "io_uring" : "recvmmsg", burst, count, result, truncated ? " TRUNCATED" : "");
+    return (result.packets == count) && (truncated == 0);
+}
+
+bool runSerial(bool uring, bool burst, long count)
+{
+    int master;
+    int slave;
+    char name[64];
+    termios raw;
+    cfmakeraw(&raw);
+    if (openpty(&master, &slave, name, &raw, nullptr) < 0) {
+        printf("serial no pseudo-terminal\n");
+        return false;
+    }
+    (void) close(slave);
+
+    TermiosSerialPort port;
+    if (!port.open(QString::fromLocal8Bit(name)) || !port.configure(921600, QSerialPort::Data8, QSerialPort::NoParity, QSerialPort::OneStop, QSerialPort::NoFlowControl)) {
+        printf("serial could not open %s\n", name);
+        (void) close(master);
+        return false;
+    }
+    SerialUringEngine uringEngine;
+    if (uring && !uringEngine.open(port.fd())) {
+        printf("serial io_uring not available\n");
+        port.close();
+        (void) close(master);
+        return false;
+    }
+
+    const long totalBytes = count * static_cast<long>(packetSize);
+    std::atomic<long> echoedBytes{0};
+    std::atomic<bool> peerDone{false};
+
+    // The peer writes frames into the master side and reads the echo back from it
+    std::thread writer([master, count, burst] {
+        char packet[packetSize] = { static_cast<char>(0xFD) };
+        for (long i = 0; i < count; i++) {
+            size_t written = 0;
+            while (written < sizeof(packet)) {
+                const ssize_t result = write(master, packet + written, sizeof(packet) - written);
+                if (result > 0) {
+                    written += static_cast<size_t>(result);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            if (!burst && ((i % pauseEvery) == 0)) {
+                (void) usleep(pauseUs);
+            }
+        }
+    });
+    std::thread reader([master, totalBytes, &echoedBytes, &peerDone] {
+        char buffer[4096];
+        pollfd waiter{ master, POLLIN, 0 };
+        while (echoedBytes < totalBytes) {
+            if (poll(&waiter, 1, idleTimeoutMs) <= 0) {
+                break;
+            }
+            const ssize_t result = read(master, buffer, sizeof(buffer));
+            if (result > 0) {
+                echoedBytes += result;
+            }
+        }
+        peerDone = true;
+    });
+
+    Result_t result;
+    long receivedBytes = 0;
+    bool failed = false;
+    const double cpuStart = threadCpuSeconds();
+    const auto start = std::chrono::steady_clock::now();
+
+    char buffer[4096];
+    while (!peerDone && !failed) {
+        if (uring) {
+            pollfd waiter{ uringEngine.eventFd(), POLLIN, 0 };
+            if (poll(&waiter, 1, 100) == 0) {
+                continue;
+            }
+            failed = uringEngine.reap([&uringEngine, &receivedBytes](const char *data, qint64 size) {
+                receivedBytes += size;
+                uringEngine.write(data, size);
+            }) < 0;
+            continue;
+        }
+
+        pollfd waiter{ port.fd(), static_cast<short>(POLLIN | ((port.bytesToWrite() > 0) ? POLLOUT : 0)), 0 };
+        if (poll(&waiter, 1, 100) == 0) {
+            continue;
+        }
+        if (waiter.revents & POLLOUT) {
+            failed = !port.flush();
+        }
+        if (waiter.revents & POLLIN) {
+            qint64 bytesRead;
+            while ((bytesRead = port.read(buffer, sizeof(buffer))) > 0) {
+                receivedBytes += bytesRead;
+                failed = failed || !port.write(buffer, bytesRead);
+            }
+            failed = failed || (bytesRead < 0);
+        }
+    }
+
+    result.cpuSeconds = threadCpuSeconds() - cpuStart;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.packets = receivedBytes / static_cast<long>(packetSize);
+    writer.join();
+    reader.join();
+    uringEngine.close();
+    port.close();
+    (void) close(master);
+
+    const bool complete = !failed && (receivedBytes == totalBytes) && (echoedBytes == totalBytes);
+    report("serial", uring ? "io_uring" : "termios", burst, count, result, complete ? "" : " INCOMPLETE");
+    return complete;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const long count = (argc > 1) ? strtol(argv[1], nullptr, 10) : 300000;
+
+    bool ok = true;
+    for (const bool burst : { false, true }) {
+        for (const bool uring : { false, true }) {
+            ok = runUdp(uring, burst, count) && ok;
+        }
+    }
+    for (const bool burst : { false, true }) {
+        for (const bool uring : { false, true }) {
+            ok = runSerial(uring, burst, count) && ok;
+        }
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,198 @@
+/*
+ * Checks that every CRC backend in mavlink/checksum.h is bit-exact with the original byte loop: over every
+ * frame the generated testsuite.h of the hypex dialect (the one the app builds) and the dialects it includes
+ * pack and send, and over random spans around MAVLINK_CRC_PCLMUL_MIN_LEN.
+ * C like the testsuite itself, which is not valid C++.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MAVLINK_USE_CONVENIENCE_FUNCTIONS
+#define MAVLINK_ASSERT(x) do { if (!(x)) { assert_failures++; } } while (0)
+
+#include <mavlink_types.h>
+
+static mavlink_system_t mavlink_system = { 42, 11 };
+static mavlink_message_t last_msg;
+static int assert_failures = 0;
+static int failures = 0;
+
+static uint8_t sent_bytes[1 << 20];
+static size_t sent_length = 0;
+static size_t parsed_frames = 0;
+
+static void comm_send_ch(mavlink_channel_t chan, uint8_t c);
+
+#include <hypex/mavlink.h>
+#include <hypex/testsuite.h>
+
+/* Every packed byte goes through the byte at a time parser, whose checksum is the reference */
+static void comm_send_ch(mavlink_channel_t chan, uint8_t c)
+{
+	mavlink_status_t status;
+	if (mavlink_parse_char(chan, c, &last_msg, &status)) {
+		parsed_frames++;
+	}
+	if (sent_length < sizeof(sent_bytes)) {
+		sent_bytes[sent_length++] = c;
+	}
+}
+
+static uint16_t crc_bytewise(uint16_t crc, const uint8_t *data, size_t length)
+{
+	while (length--) {
+		crc_accumulate(*data++, &crc);
+	}
+	return crc;
+}
+
+static int have_pclmul(void)
+{
+#ifdef MAVLINK_CRC_PCLMUL
+	return crc_have_pclmul();
+#else
+	return 0;
+#endif
+}
+
+static void check(const char *what, size_t length, uint16_t expected, uint16_t actual)
+{
+	if (expected != actual) {
+		failures++;
+		if (failures <= 20) {
+			printf("FAIL %s length %zu: expected 0x%04x got 0x%04x\n", what, length, expected, actual);
+		}
+	}
+}
+
+/* Every backend against the byte loop */
+static void check_span(uint16_t crc, const uint8_t *data, size_t length)
+{
+	const uint16_t expected = crc_bytewise(crc, data, length);
+	uint16_t buffered = crc;
+
+#ifndef MAVLINK_CRC_BYTEWISE
+	check("slice8", length, expected, crc_accumulate_slice8(crc, data, length));
+#endif
+#ifdef MAVLINK_CRC_PCLMUL
+	if (length >= 32 && have_pclmul()) {
+		check("pclmul", length, expected, crc_accumulate_pclmul(crc, data, length));
+	}
+#endif
+	crc_accumulate_buffer(&buffered, (const char *)data, (uint16_t)length);
+	check("crc_accumulate_buffer", length, expected, buffered);
+}
+
+/* Splits the sent stream into frames, checks their checksum field and every backend over their crc range */
+static size_t check_sent_frames(void)
+{
+	size_t frames = 0;
+	size_t pos = 0;
+
+	while (pos < sent_length) {
+		const uint8_t *frame = &sent_bytes[pos];
+		const size_t remaining = sent_length - pos;
+		const mavlink_msg_entry_t *entry;
+		size_t header_length, crc_length, frame_length;
+		uint32_t msgid;
+		int signature = 0;
+		uint16_t crc;
+
+		if (frame[0] == MAVLINK_STX && remaining >= MAVLINK_NUM_HEADER_BYTES) {
+			header_length = MAVLINK_NUM_HEADER_BYTES;
+			msgid = frame[7] | (frame[8] << 8) | ((uint32_t)frame[9] << 16);
+			signature = (frame[2] & MAVLINK_IFLAG_SIGNED) != 0;
+		} else if (frame[0] == MAVLINK_STX_MAVLINK1 && remaining >= MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1) {
+			header_length = MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1;
+			msgid = frame[5];
+		} else {
+			printf("FAIL unexpected byte 0x%02x at %zu\n", frame[0], pos);
+			failures++;
+			break;
+		}
+
+		crc_length = header_length - 1 + frame[1];
+		frame_length = header_length + frame[1] + MAVLINK_NUM_CHECKSUM_BYTES + (signature ? MAVLINK_SIGNATURE_BLOCK_LEN : 0);
+		if (frame_length > remaining) {
+			printf("FAIL truncated frame at %zu\n", pos);
+			failures++;
+			break;
+		}
+
+		entry = mavlink_get_msg_entry(msgid);
+		if (!entry) {
+			printf("FAIL unknown msgid %u\n", (unsigned)msgid);
+			failures++;
+		} else {
+			crc = crc_bytewise(X25_INIT_CRC, frame + 1, crc_length);
+			crc_accumulate(entry->crc_extra, &crc);
+			check("packed frame", crc_length, crc, (uint16_t)(frame[1 + crc_length] | (frame[2 + crc_length] << 8)));
+		}
+
+		check_span(X25_INIT_CRC, frame + 1, crc_length);
+		frames++;
+		pos += frame_length;
+	}
+	return frames;
+}
+
+/* Random data, initial crc and alignment, every length up to three times the PCLMUL threshold */
+static size_t check_random_spans(void)
+{
+#ifdef MAVLINK_CRC_PCLMUL_MIN_LEN
+	const size_t max_length = 3 * MAVLINK_CRC_PCLMUL_MIN_LEN + 32;
+#else
+	const size_t max_length = 3 * 96 + 32;
+#endif
+	uint8_t buffer[16 + 3 * 256];
+	size_t spans = 0;
+	size_t length, i;
+	int round;
+
+	srand(0x4d41564c);
+	for (i = 0; i < sizeof(buffer); i++) {
+		buffer[i] = (uint8_t)rand();
+	}
+
+	for (length = 0; length <= max_length; length++) {
+		for (round = 0; round < 16; round++) {
+			check_span((uint16_t)rand(), &buffer[rand() % 16], length);
+			spans++;
+		}
+	}
+	return spans;
+}
+
+int main(void)
+{
+	size_t frames, spans;
+
+	/* The generated mavlink_test_all only runs the top two dialects */
+	mavlink_test_minimal(mavlink_system.sysid, mavlink_system.compid, &last_msg);
+	mavlink_test_standard(mavlink_system.sysid, mavlink_system.compid, &last_msg);
+	mavlink_test_common(mavlink_system.sysid, mavlink_system.compid, &last_msg);
+	mavlink_test_uAvionix(mavlink_system.sysid, mavlink_system.compid, &last_msg);
+	mavlink_test_icarous(mavlink_system.sysid, mavlink_system.compid, &last_msg);
+	mavlink_test_loweheiser(mavlink_system.sysid, mavlink_system.compid, &last_msg);
+	mavlink_test_cubepilot(mavlink_system.sysid, mavlink_system.compid, &last_msg);
+	mavlink_test_csAirLink(mavlink_system.sysid, mavlink_system.compid, &last_msg);
+	mavlink_test_ardupilotmega(mavlink_system.sysid, mavlink_system.compid, &last_msg);
+	mavlink_test_hypex(mavlink_system.sysid, mavlink_system.compid, &last_msg);
+	if (assert_failures > 0) {
+		printf("FAIL %d testsuite assertions\n", assert_failures);
+		failures++;
+	}
+
+	frames = check_sent_frames();
+	if (frames != parsed_frames) {
+		printf("FAIL %zu frames sent, %zu parsed\n", frames, parsed_frames);
+		failures++;
+	}
+	spans = check_random_spans();
+
+	printf("%zu testsuite frames, %zu random spans, pclmul %s: %s\n", frames, spans,
+	       have_pclmul() ? "tested" : "not available", failures == 0 ? "ok" : "FAILED");
+	return failures == 0 ? 0 : 1;
+}
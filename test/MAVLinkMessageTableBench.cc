@@ -0,0 +1,121 @@
+// MAVLinkMessageTable lookups against the bisection search of the stock mavlink_get_msg_entry(), over the
+// msgid mix of a typical ArduPilot telemetry stream, every msgid of the dialect and msgids not in it.
+// Both lookups are cross checked over the whole 24 bit msgid range first.
+//
+//   MAVLinkMessageTableBench [lookups per mix], from a Release build
+
+#include "MAVLinkMessageTable.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+/// mavlink_get_msg_entry() from mavlink_helpers.h without MAVLINK_GET_MSG_ENTRY
+inline const mavlink_msg_entry_t *bisectEntry(uint32_t msgid)
+{
+    static const mavlink_msg_entry_t mavlink_message_crcs[] = MAVLINK_MESSAGE_CRCS;
+    uint32_t low = 0, high = sizeof(mavlink_message_crcs) / sizeof(mavlink_message_crcs[0]) - 1;
+    while (low < high) {
+        const uint32_t mid = (low + 1 + high) / 2;
+        if (msgid < mavlink_message_crcs[mid].msgid) {
+            high = mid - 1;
+            continue;
+        }
+        if (msgid > mavlink_message_crcs[mid].msgid) {
+            low = mid;
+            continue;
+        }
+        low = mid;
+        break;
+    }
+    if (mavlink_message_crcs[low].msgid != msgid) {
+        return nullptr;
+    }
+    return &mavlink_message_crcs[low];
+}
+
+bool crossCheck()
+{
+    for (uint32_t msgid = 0; msgid <= 0xFFFFFF; msgid++) {
+        const mavlink_msg_entry_t *const expected = bisectEntry(msgid);
+        const mavlink_msg_entry_t *const actual = MAVLinkMessageTable::entry(msgid);
+        if ((expected == nullptr) != (actual == nullptr) || (expected && (expected->crc_extra != actual->crc_extra || expected->max_msg_len != actual->max_msg_len))) {
+            printf("FAIL msgid %u\n", msgid);
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Lookup>
+double nsPerLookup(const std::vector<uint32_t> &msgids, Lookup &&lookup, unsigned &sink)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (const uint32_t msgid : msgids) {
+        const mavlink_msg_entry_t *const entry = lookup(msgid);
+        sink += entry ? entry->crc_extra : 1;
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / msgids.size();
+}
+
+void run(const char *mix, const std::vector<uint32_t> &msgids)
+{
+    unsigned sink = 0;
+    double bisect = 1e9, table = 1e9, installed = 1e9;
+    // Best of 5, interleaved so frequency changes hit both alike
+    for (int round = 0; round < 5; round++) {
+        bisect = std::min(bisect, nsPerLookup(msgids, bisectEntry, sink));
+        table = std::min(table, nsPerLookup(msgids, MAVLinkMessageTable::entry, sink));
+        installed = std::min(installed, nsPerLookup(msgids, mavlink_get_msg_entry, sink));
+    }
+    printf("%-10s bisection %6.2f ns  table %6.2f ns  mavlink_get_msg_entry %6.2f ns  (%.1fx)  [%u]\n",
+           mix, bisect, table, installed, bisect / table, sink & 1);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const size_t count = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 10000000;
+
+    if (!crossCheck()) {
+        return 1;
+    }
+    printf("%zu dialect messages, lookups agree for all 2^24 msgids\n", MAVLinkMessageTable::entryCount);
+
+    std::mt19937 random(1);
+    std::vector<uint32_t> msgids(count);
+
+    static constexpr uint32_t telemetry[] = {
+        MAVLINK_MSG_ID_HEARTBEAT, MAVLINK_MSG_ID_SYS_STATUS, MAVLINK_MSG_ID_ATTITUDE, MAVLINK_MSG_ID_ATTITUDE,
+        MAVLINK_MSG_ID_ATTITUDE, MAVLINK_MSG_ID_GLOBAL_POSITION_INT, MAVLINK_MSG_ID_GLOBAL_POSITION_INT,
+        MAVLINK_MSG_ID_VFR_HUD, MAVLINK_MSG_ID_GPS_RAW_INT, MAVLINK_MSG_ID_RC_CHANNELS, MAVLINK_MSG_ID_SERVO_OUTPUT_RAW,
+        MAVLINK_MSG_ID_RAW_IMU, MAVLINK_MSG_ID_SCALED_PRESSURE, MAVLINK_MSG_ID_AHRS2, MAVLINK_MSG_ID_SYSTEM_TIME,
+        MAVLINK_MSG_ID_BATTERY_STATUS, MAVLINK_MSG_ID_EKF_STATUS_REPORT, MAVLINK_MSG_ID_VIBRATION,
+        MAVLINK_MSG_ID_TIMESYNC, MAVLINK_MSG_ID_ESC_TELEMETRY_1_TO_4,
+    };
+    for (uint32_t &msgid : msgids) {
+        msgid = telemetry[random() % (sizeof(telemetry) / sizeof(telemetry[0]))];
+    }
+    run("telemetry", msgids);
+
+    for (uint32_t &msgid : msgids) {
+        msgid = MAVLinkMessageTable::entries[random() % MAVLinkMessageTable::entryCount].msgid;
+    }
+    run("dialect", msgids);
+
+    for (uint32_t &msgid : msgids) {
+        do {
+            msgid = random() % (MAVLinkMessageTable::entries[MAVLinkMessageTable::entryCount - 1].msgid + 1);
+        } while (MAVLinkMessageTable::entry(msgid));
+    }
+    run("unknown", msgids);
+
+    return 0;
+}